@@ -0,0 +1,7 @@
+#include "ColumnJobCache.h"
+
+void
+ColumnJobCacheBase::onJobFinished(void)
+{
+    this->finishJob(this->sender()->property("column").toInt());
+}
@@ -0,0 +1,131 @@
+#ifndef COLUMN_JOB_CACHE_H
+#define COLUMN_JOB_CACHE_H
+
+#include <QObject>
+#include <QVector>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QVariant>
+#include <QtConcurrent/QtConcurrentRun>
+#include "ResultsTableModel.h"
+
+//
+// the result of a job (a sort, a density estimate, ..) on each column of a ResultsTableModel,
+// each run once, on the thread pool, the first time it is asked for. A job still running when
+// the cache goes keeps its own copy of the column and is left to finish. When rows are added to
+// the table the cache is invalidated: the results it has are out of date, not ready, and a
+// column is run again when next asked for, or at once if its job was running. The signal is in a
+// base class as moc does not do templates
+//
+
+class ColumnJobCacheBase : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ColumnJobCacheBase(QObject *parent = 0) : QObject(parent) {}
+
+signals:
+    void columnReady(int col);
+
+protected slots:
+    void onJobFinished(void);
+
+protected:
+    virtual void finishJob(int col) = 0;
+};
+
+template <typename T>
+class ColumnJobCache : public ColumnJobCacheBase
+{
+public:
+    typedef T (*Job)(const QVector<double> &values);
+
+    ColumnJobCache(const ResultsTableModel *table, Job job, QObject *parent = 0)
+        : ColumnJobCacheBase(parent), theTable(table), theJob(job), generation(0)
+    {
+        entries.resize(theTable->columnCount());
+    }
+
+    // starts the job on the column in the background unless it is up to date or under way
+    void request(int col)
+    {
+        if (col < 0 || col >= entries.size())
+            return;
+
+        Entry &theEntry = entries[col];
+        if (theEntry.watcher != 0 || (theEntry.done && theEntry.resultGeneration == generation))
+            return;
+
+        // the column is shared with the job, not copied
+        QVector<double> values = theTable->getColumn(col).values;
+        theEntry.future = QtConcurrent::run(theJob, values);
+        theEntry.jobGeneration = generation;
+
+        theEntry.watcher = new QFutureWatcher<T>(this);
+        theEntry.watcher->setProperty("column", col);
+        connect(theEntry.watcher, SIGNAL(finished()), this, SLOT(onJobFinished()));
+        theEntry.watcher->setFuture(theEntry.future);
+    }
+
+    // true if the result for the table as it is now is there, get will not wait
+    bool isReady(int col) const
+    {
+        const Entry &theEntry = entries.at(col);
+        if (theEntry.watcher != 0)
+            return theEntry.future.isFinished() && theEntry.jobGeneration == generation;
+        return theEntry.done && theEntry.resultGeneration == generation;
+    }
+
+    // the results there are become out of date
+    void invalidate(void) {generation++;}
+
+    // the latest result, waiting for the job if there is none yet
+    const T &get(int col)
+    {
+        Entry &theEntry = entries[col];
+        if (!theEntry.done || (theEntry.watcher != 0 && theEntry.future.isFinished())) {
+            this->request(col);
+            theEntry.result = theEntry.future.result();
+            theEntry.resultGeneration = theEntry.jobGeneration;
+            theEntry.done = true;
+        }
+        return theEntry.result;
+    }
+
+protected:
+    void finishJob(int col)
+    {
+        Entry &theEntry = entries[col];
+        theEntry.result = theEntry.future.result();
+        theEntry.resultGeneration = theEntry.jobGeneration;
+        theEntry.done = true;
+        theEntry.watcher->deleteLater();
+        theEntry.watcher = 0;
+
+        // rows were added while the job ran, it is run again on the table as it is now
+        if (theEntry.resultGeneration != generation) {
+            this->request(col);
+            return;
+        }
+        emit columnReady(col);
+    }
+
+private:
+    struct Entry
+    {
+        Entry() : watcher(0), done(false), jobGeneration(0), resultGeneration(0) {}
+        QFuture<T> future;
+        QFutureWatcher<T> *watcher;
+        T result;
+        bool done;
+        int jobGeneration;      // of the table when the job running was started
+        int resultGeneration;   // of the table the result is for
+    };
+
+    const ResultsTableModel *theTable;
+    Job theJob;
+    int generation;             // the number of times the table has been added to
+    QVector<Entry> entries;
+};
+
+#endif // COLUMN_JOB_CACHE_H
@@ -0,0 +1,268 @@
+#include "DakotaTabParser.h"
+#include <QFile>
+#include <QByteArray>
+#include <QHash>
+#include <QtConcurrent/QtConcurrentMap>
+#include <string.h>
+
+#if defined(__has_include) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#define DEFAULT_CHUNK_SIZE (4 << 20)
+
+//
+// the lines of one chunk, parsed into columns of its own
+//
+
+struct TabChunk
+{
+    const char *begin;
+    const char *end;
+    int numCol;
+    int numRows;
+    QVector<ResultsTableModel::Column> columns;
+};
+
+static inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+//
+// numbers are read with from_chars where the library has it and with QByteArray otherwise,
+// neither depends on the locale (Qt sets the user's locale, in which strtod may want a comma)
+//
+
+static bool parseNumber(const char *token, const char *tokenEnd, double &value)
+{
+    if (token == tokenEnd) {
+        value = 0.0; // a missing value
+        return true;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    const char *start = (*token == '+') ? token+1 : token;
+    std::from_chars_result result = std::from_chars(start, tokenEnd, value);
+    if (result.ec == std::errc())
+        return result.ptr == tokenEnd;
+    if (result.ec != std::errc::result_out_of_range)
+        return false;
+#endif
+
+    bool ok;
+    value = QByteArray::fromRawData(token, tokenEnd-token).toDouble(&ok);
+    return ok;
+}
+
+//
+// the number of a text in a column dictionary, the text is added if new
+//
+
+static int encodeText(QStringList &dictionary, QHash<QString, int> &index, const QString &text)
+{
+    QHash<QString, int>::const_iterator found = index.constFind(text);
+    if (found != index.constEnd())
+        return found.value();
+    dictionary << text;
+    index.insert(text, dictionary.size());
+    return dictionary.size();
+}
+
+static void parseChunk(TabChunk &chunk)
+{
+    int numCol = chunk.numCol;
+    chunk.numRows = 0;
+    chunk.columns.resize(numCol);
+    QVector<QHash<QString, int> > index(numCol);
+
+    // a guess at the number of rows from the length of the first line
+    const char *firstEnd = (const char *)memchr(chunk.begin, '\n', chunk.end-chunk.begin);
+    if (firstEnd != 0 && firstEnd > chunk.begin) {
+        int guess = (chunk.end-chunk.begin)/(firstEnd-chunk.begin+1) + 1;
+        for (int col=0; col<numCol; col++)
+            chunk.columns[col].values.reserve(guess);
+    }
+
+    const char *pos = chunk.begin;
+    while (pos < chunk.end) {
+        const char *lineEnd = (const char *)memchr(pos, '\n', chunk.end-pos);
+        if (lineEnd == 0)
+            lineEnd = chunk.end;
+
+        // the tokens of the line, skipping the interface column; a short line has empty cells
+        const char *token = pos;
+        int col = 0;
+        for (int i=0; col<numCol; i++) {
+            while (token < lineEnd && isBlank(*token))
+                token++;
+            if (token == lineEnd && i == 0)
+                break; // blank line
+            const char *tokenEnd = token;
+            while (tokenEnd < lineEnd && !isBlank(*tokenEnd))
+                tokenEnd++;
+
+            if (i != 1) {
+                ResultsTableModel::Column &theColumn = chunk.columns[col];
+                double value;
+                bool isNumber = parseNumber(token, tokenEnd, value);
+                bool isText = !theColumn.dictionary.isEmpty();
+
+                if (!isNumber && !isText) {
+                    // first text in the column, the numbers before it are encoded too
+                    QVector<double> &values = theColumn.values;
+                    for (int j=0; j<values.size(); j++)
+                        values[j] = encodeText(theColumn.dictionary, index[col], QString::number(values.at(j), 'g', 10));
+                    isText = true;
+                }
+                if (isText)
+                    value = encodeText(theColumn.dictionary, index[col], QString::fromLatin1(token, tokenEnd-token));
+                theColumn.values.append(value);
+                col++;
+            }
+            token = tokenEnd;
+        }
+        if (col != 0)
+            chunk.numRows++;
+
+        pos = lineEnd+1;
+    }
+}
+
+DakotaTabParser::DakotaTabParser()
+    : chunkSize(DEFAULT_CHUNK_SIZE)
+{
+
+}
+
+DakotaTabParser::~DakotaTabParser()
+{
+
+}
+
+int
+DakotaTabParser::parse(const QString &filenameTab, QStringList &headings, QVector<ResultsTableModel::Column> &columns)
+{
+    QFile tabFile(filenameTab);
+    if (!tabFile.open(QFile::ReadOnly))
+        return -1;
+
+    // mapped if the file system allows it, read otherwise
+    qint64 size = tabFile.size();
+    QByteArray contents;
+    const char *data = (size > 0) ? (const char *)tabFile.map(0, size) : 0;
+    bool isMapped = (data != 0);
+    if (!isMapped) {
+        contents = tabFile.readAll();
+        data = contents.constData();
+        size = contents.size();
+    }
+    const char *end = data + size;
+
+    const char *lineEnd = (const char *)memchr(data, '\n', size);
+    if (lineEnd == 0)
+        lineEnd = end;
+    headings << DakotaTabParser::parseHeadings(data, lineEnd);
+
+    const char *body = (lineEnd < end) ? lineEnd+1 : end;
+    int numRows = this->parseRows(body, end, headings.size(), columns);
+
+    if (isMapped)
+        tabFile.unmap((uchar *)data);
+
+    return numRows;
+}
+
+QStringList
+DakotaTabParser::parseHeadings(const char *begin, const char *end)
+{
+    QList<QByteArray> names = QByteArray(begin, end-begin).simplified().split(' ');
+    QStringList headings;
+    headings << "Run #";
+    for (int i=2; i<names.size(); i++)
+        headings << QString(names.at(i));
+    return headings;
+}
+
+int
+DakotaTabParser::parseRows(const char *body, const char *end, int numCol, QVector<ResultsTableModel::Column> &columns)
+{
+    //
+    // cut into chunks at line ends, parsed in parallel
+    //
+
+    qint64 bodySize = end-body;
+    int numChunks = (chunkSize > 0) ? bodySize/chunkSize + 1 : 1;
+
+    QVector<TabChunk> chunks;
+    const char *chunkBegin = body;
+    for (int i=1; i<=numChunks && chunkBegin < end; i++) {
+        const char *chunkEnd = end;
+        if (i < numChunks) {
+            chunkEnd = (const char *)memchr(body + bodySize*i/numChunks, '\n', end - (body + bodySize*i/numChunks));
+            chunkEnd = (chunkEnd == 0) ? end : chunkEnd+1;
+            if (chunkEnd <= chunkBegin)
+                continue;
+        }
+        TabChunk theChunk;
+        theChunk.begin = chunkBegin;
+        theChunk.end = chunkEnd;
+        theChunk.numCol = numCol;
+        theChunk.numRows = 0;
+        chunks.append(theChunk);
+        chunkBegin = chunkEnd;
+    }
+
+    if (chunks.size() > 1)
+        QtConcurrent::blockingMap(chunks, parseChunk);
+    else if (chunks.size() == 1)
+        parseChunk(chunks[0]);
+
+    //
+    // the chunks joined in order, a column is text if it is text in any chunk
+    //
+
+    int numRows = 0;
+    for (int i=0; i<chunks.size(); i++)
+        numRows += chunks.at(i).numRows;
+
+    columns.resize(numCol);
+    for (int col=0; col<numCol; col++) {
+        bool isText = false;
+        for (int i=0; i<chunks.size(); i++)
+            isText = isText || !chunks.at(i).columns.at(col).dictionary.isEmpty();
+
+        ResultsTableModel::Column &theColumn = columns[col];
+        theColumn.values.clear();
+        theColumn.dictionary.clear();
+        theColumn.values.reserve(numRows);
+        QHash<QString, int> index;
+
+        for (int i=0; i<chunks.size(); i++) {
+            ResultsTableModel::Column &chunkColumn = chunks[i].columns[col];
+            const QVector<double> &values = chunkColumn.values;
+
+            if (!isText) {
+                theColumn.values += values;
+            } else if (chunkColumn.dictionary.isEmpty()) {
+                for (int j=0; j<values.size(); j++)
+                    theColumn.values.append(encodeText(theColumn.dictionary, index, QString::number(values.at(j), 'g', 10)));
+            } else {
+                // the chunk dictionary is merged, its numbers renumbered in the column's
+                QVector<int> code(chunkColumn.dictionary.size()+1);
+                for (int k=0; k<chunkColumn.dictionary.size(); k++)
+                    code[k+1] = encodeText(theColumn.dictionary, index, chunkColumn.dictionary.at(k));
+                for (int j=0; j<values.size(); j++)
+                    theColumn.values.append(code.at(int(values.at(j))));
+            }
+
+            // the chunk is done with, free it as we go
+            chunkColumn.values = QVector<double>();
+            chunkColumn.dictionary.clear();
+        }
+    }
+
+    return numRows;
+}
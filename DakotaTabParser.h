@@ -0,0 +1,39 @@
+#ifndef DAKOTA_TAB_PARSER_H
+#define DAKOTA_TAB_PARSER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <ResultsTableModel.h>
+
+//
+// reads a dakotaTab file into the columns of a ResultsTableModel. The file is mapped, not read,
+// and cut into chunks at line ends that are parsed on the thread pool, each into columns of its
+// own which are then joined in file order. The heading line gives the columns: the run number,
+// then those after the interface column; each following line is a row. A column with any value
+// that is not a number is dictionary encoded
+//
+
+class DakotaTabParser
+{
+public:
+    DakotaTabParser();
+    ~DakotaTabParser();
+
+    // returns the number of rows, -1 if the file could not be read
+    int parse(const QString &filenameTab, QStringList &headings, QVector<ResultsTableModel::Column> &columns);
+
+    // the headings of a heading line (its end not included)
+    static QStringList parseHeadings(const char *begin, const char *end);
+
+    // the rows of whole lines into numCol columns, returns the number of rows
+    int parseRows(const char *begin, const char *end, int numCol, QVector<ResultsTableModel::Column> &columns);
+
+    // the size of the chunks handed to the threads
+    void setChunkSize(qint64 size) {chunkSize = size;}
+
+private:
+    qint64 chunkSize;
+};
+
+#endif // DAKOTA_TAB_PARSER_H
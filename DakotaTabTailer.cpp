@@ -0,0 +1,83 @@
+#include "DakotaTabTailer.h"
+#include "DakotaTabParser.h"
+#include <QFile>
+#include <QTimer>
+#include <QByteArray>
+#include <string.h>
+
+DakotaTabTailer::DakotaTabTailer(QObject *parent)
+    : QObject(parent), offset(0)
+{
+    theTimer = new QTimer(this);
+    connect(theTimer, SIGNAL(timeout()), this, SLOT(readNew()));
+}
+
+DakotaTabTailer::~DakotaTabTailer()
+{
+
+}
+
+void
+DakotaTabTailer::start(const QString &filenameTab, int interval)
+{
+    theFilename = filenameTab;
+    offset = 0;
+    theHeadings.clear();
+    theTimer->start(interval);
+    this->readNew();
+}
+
+void
+DakotaTabTailer::stop(void)
+{
+    theTimer->stop();
+}
+
+bool
+DakotaTabTailer::isWatching(void) const
+{
+    return theTimer->isActive();
+}
+
+void
+DakotaTabTailer::readNew(void)
+{
+    QFile tabFile(theFilename);
+    if (!tabFile.open(QFile::ReadOnly))
+        return;
+
+    qint64 size = tabFile.size();
+    if (size < offset) {
+        offset = 0;
+        theHeadings.clear();
+        emit restarted();
+        return;
+    }
+    if (size == offset || !tabFile.seek(offset))
+        return;
+
+    //
+    // what is new, less any line not yet finished
+    //
+
+    QByteArray contents = tabFile.read(size - offset);
+    int length = contents.lastIndexOf('\n') + 1;
+    if (length == 0)
+        return;
+    offset += length;
+
+    const char *data = contents.constData();
+    const char *end = data + length;
+
+    if (theHeadings.isEmpty()) {
+        const char *lineEnd = (const char *)memchr(data, '\n', length);
+        theHeadings = DakotaTabParser::parseHeadings(data, lineEnd);
+        emit headingsRead(theHeadings);
+        data = lineEnd+1;
+    }
+
+    QVector<ResultsTableModel::Column> rows;
+    DakotaTabParser theParser;
+    if (data < end && theParser.parseRows(data, end, theHeadings.size(), rows) > 0)
+        emit rowsRead(rows);
+}
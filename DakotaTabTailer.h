@@ -0,0 +1,49 @@
+#ifndef DAKOTA_TAB_TAILER_H
+#define DAKOTA_TAB_TAILER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <ResultsTableModel.h>
+
+class QTimer;
+
+//
+// follows a dakotaTab file while dakota writes it, so the results of a run can be looked at
+// before it ends. The file is looked at every interval; only what has been added since is read,
+// up to the last whole line, and parsed (see DakotaTabParser) into rows handed on by rowsRead.
+// The file need not exist yet. A file that gets shorter has been started over: restarted is
+// emitted and the file is read again from the top the next time
+//
+
+class DakotaTabTailer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DakotaTabTailer(QObject *parent = 0);
+    ~DakotaTabTailer();
+
+    void start(const QString &filenameTab, int interval = 1000);
+    void stop(void);
+    bool isWatching(void) const;
+
+    const QString &getFilename(void) const {return theFilename;}
+    const QStringList &getHeadings(void) const {return theHeadings;}
+
+signals:
+    void headingsRead(const QStringList &headings);
+    void rowsRead(const QVector<ResultsTableModel::Column> &rows);
+    void restarted(void);
+
+public slots:
+    void readNew(void);
+
+private:
+    QString theFilename;
+    QTimer *theTimer;
+    qint64 offset;            // the bytes of the file read so far, all whole lines
+    QStringList theHeadings;
+};
+
+#endif // DAKOTA_TAB_TAILER_H
@@ -0,0 +1,14 @@
+#include "DensityEngine.h"
+
+static DensityEstimate estimateColumn(const QVector<double> &values)
+{
+    DensityEstimate theEstimate;
+    computeDensityEstimate(values.constData(), values.size(), theEstimate);
+    return theEstimate;
+}
+
+DensityEngine::DensityEngine(const ResultsTableModel *table, QObject *parent)
+    : ColumnJobCache<DensityEstimate>(table, estimateColumn, parent)
+{
+
+}
@@ -0,0 +1,21 @@
+#ifndef DENSITY_ENGINE_H
+#define DENSITY_ENGINE_H
+
+#include <ColumnJobCache.h>
+#include <DensityEstimate.h>
+
+//
+// the histogram and kernel density (see DensityEstimate) of the columns of a ResultsTableModel,
+// each computed in the background the first time it is asked for (see ColumnJobCache)
+//
+
+class DensityEngine : public ColumnJobCache<DensityEstimate>
+{
+public:
+    explicit DensityEngine(const ResultsTableModel *theTable, QObject *parent = 0);
+
+    // waits for the estimate if it is not done yet
+    const DensityEstimate &getDensity(int col) {return this->get(col);}
+};
+
+#endif // DENSITY_ENGINE_H
@@ -31,6 +31,8 @@ include(../GroundMotionUtilities/UI/GroundMotionWidgets.pri)
 include(../SiteResponseTool/SiteResponseTool.pri)
 include(./MiniZip/MiniZip.pri)
 
+INCLUDEPATH += applications/common
+
 SOURCES += main.cpp \
     WorkflowAppGMT.cpp \
     ResultsGMT.cpp \
@@ -39,7 +41,21 @@ SOURCES += main.cpp \
     timeIntegrators.cpp \
     calcResponseSpectrum.cpp \
     qcustomplot.cpp \
-    ResponseWidget.cpp
+    ResponseWidget.cpp \
+    ResultsTableModel.cpp \
+    ResultsTableView.cpp \
+    DakotaTabParser.cpp \
+    ColumnJobCache.cpp \
+    SortedColumnCache.cpp \
+    DensityEngine.cpp \
+    ResultsColumnFile.cpp \
+    SpectrumEngine.cpp \
+    DakotaTabTailer.cpp \
+    applications/common/TimeSeriesFile.cpp \
+    applications/common/Units.cpp \
+    applications/common/DensityEstimate.cpp \
+    applications/common/SpectrumStatistics.cpp \
+    applications/common/FFT.cpp
 
 HEADERS  += \
     WorkflowAppGMT.h \
@@ -48,7 +64,21 @@ HEADERS  += \
     RunWidget.h \ 
     timeIntegrators.h \
     qcustomplot.h \
-    ResponseWidget.h
+    ResponseWidget.h \
+    ResultsTableModel.h \
+    ResultsTableView.h \
+    DakotaTabParser.h \
+    ColumnJobCache.h \
+    SortedColumnCache.h \
+    DensityEngine.h \
+    ResultsColumnFile.h \
+    SpectrumEngine.h \
+    DakotaTabTailer.h \
+    applications/common/TimeSeriesFile.h \
+    applications/common/Units.h \
+    applications/common/DensityEstimate.h \
+    applications/common/SpectrumStatistics.h \
+    applications/common/FFT.h
 
 RESOURCES += \
     #resources.qrc
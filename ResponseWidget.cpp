@@ -19,6 +19,8 @@ ResponseWidget::ResponseWidget(
     maxValue = 0;
     xMinValue = 0;
     xMaxValue = 0;
+    for (int i=0; i<3; i++)
+        percentileGraphs[i] = 0;
     // create a main layout
     QVBoxLayout *mainLayout = new QVBoxLayout();
 
@@ -43,6 +45,9 @@ ResponseWidget::ResponseWidget(
     thePlot->setMinimumHeight(height);
     mainLayout->addWidget(thePlot);
 
+    caption = new QLabel();
+    mainLayout->addWidget(caption);
+
     thePlot->xAxis->setLabel(xLabel);
     thePlot->yAxis->setLabel(yLabel);
 
@@ -58,6 +63,9 @@ void
 ResponseWidget::clear() {
    thePlot->clearGraphs();
     thePlot->clearPlottables();
+    for (int i=0; i<3; i++)
+        percentileGraphs[i] = 0;
+    caption->clear();
     numGraphs=0;
     minValue = 0;
     maxValue = 0;
@@ -81,7 +89,7 @@ ResponseWidget::addData(QVector<double> &data, QVector<double> &time, int numSte
     }
 
     graph = thePlot->addGraph();
-    thePlot->graph(numGraphs)->setData(time, data);
+    graph->setData(time, data);
     numGraphs++;
 
 
@@ -104,12 +112,6 @@ ResponseWidget::addData(QVector<double> &data, QVector<double> &time, int numSte
 void
 ResponseWidget::addData(QVector<double> &data, QVector<double> &x) {
 
-    qDebug() << data.size();
-    qDebug() << x.size();
-    qDebug() << data;
-    qDebug() << x;
-
-
     /*
      *
      * thePlot->clearGraphs();
@@ -118,12 +120,17 @@ ResponseWidget::addData(QVector<double> &data, QVector<double> &x) {
 
     curve->setData(x,data);
 */
+    int numSteps = data.size();
+    if (numGraphs == 0 && numSteps != 0) {
+        // the x range starts from the first data, not 0, which a log axis can not show
+        xMinValue = x.at(0);
+        xMaxValue = x.at(0);
+    }
+
     graph = thePlot->addGraph();
-    thePlot->graph(numGraphs)->setData(x, data, true);
+    graph->setData(x, data, true);
     numGraphs++;
 
-    int numSteps = data.size();
-
     for (int i=0; i<numSteps; i++) {
         double value = data.at(i);
         double xValue = x.at(i);
@@ -143,3 +150,51 @@ ResponseWidget::addData(QVector<double> &data, QVector<double> &x) {
     thePlot->replot();
 }
 
+void
+ResponseWidget::setXAxisLogarithmic(bool logarithmic) {
+    if (logarithmic)
+        thePlot->xAxis->setScaleType(QCPAxis::stLogarithmic);
+    else
+        thePlot->xAxis->setScaleType(QCPAxis::stLinear);
+}
+
+void
+ResponseWidget::setPercentiles(QVector<double> &x, QVector<double> &median, QVector<double> &lower, QVector<double> &upper) {
+
+    QVector<double> *curves[3] = {&median, &lower, &upper};
+    for (int i=0; i<3; i++) {
+        if (percentileGraphs[i] == 0) {
+            percentileGraphs[i] = thePlot->addGraph();
+            QPen pen(Qt::red);
+            pen.setWidth(i == 0 ? 3 : 2);
+            if (i != 0)
+                pen.setStyle(Qt::DashLine);
+            percentileGraphs[i]->setPen(pen);
+        }
+        percentileGraphs[i]->setData(x, *curves[i], true);
+
+        for (int j=0; j<curves[i]->size(); j++) {
+            double value = curves[i]->at(j);
+            if (value > maxValue)
+                maxValue = value;
+        }
+    }
+
+    if (!x.isEmpty()) {
+        if (numGraphs == 0) {
+            xMinValue = x.first();
+            xMaxValue = x.last();
+        }
+        xMinValue = qMin(xMinValue, x.first());
+        xMaxValue = qMax(xMaxValue, x.last());
+    }
+
+    thePlot->yAxis->setRange(minValue, maxValue);
+    thePlot->xAxis->setRange(xMinValue, xMaxValue);
+    thePlot->replot();
+}
+
+void
+ResponseWidget::setCaption(const QString &text) {
+    caption->setText(text);
+}
@@ -11,6 +11,7 @@ class QCPCurve;
 class QCPItemTracer;
 class MainWindow;
 class QSpinBox;
+class QLabel;
 
 
 //
@@ -29,6 +30,11 @@ public:
     void clear();
     void addData(QVector<double> &data, QVector<double> &time, int numSteps, double dt);
     void addData(QVector<double> &data, QVector<double> &x);
+    void setXAxisLogarithmic(bool logarithmic);
+
+    // curves over the data, replaced on each call, and a line of text under the plot
+    void setPercentiles(QVector<double> &x, QVector<double> &median, QVector<double> &lower, QVector<double> &upper);
+    void setCaption(const QString &text);
 
 signals:
 
@@ -42,6 +48,8 @@ private:
     QCPGraph *graph;
     QCPItemTracer *groupTracer;
     QCPCurve *curve;
+    QCPGraph *percentileGraphs[3];
+    QLabel *caption;
     int numGraphs;
     double minValue;
     double maxValue;
@@ -0,0 +1,169 @@
+#include "ResultsColumnFile.h"
+#include <QSaveFile>
+#include <QDataStream>
+#include <QByteArray>
+#include <string.h>
+#include <limits.h>
+
+#define ROWS_PER_CHUNK 65536
+#define FILE_MAGIC "GMTRCOL1"
+#define BYTE_ORDER_MARK 0x01020304
+
+ResultsColumnFile::ResultsColumnFile()
+    : data(0), size(0), numRows(0), rowsPerChunk(ROWS_PER_CHUNK)
+{
+
+}
+
+ResultsColumnFile::~ResultsColumnFile()
+{
+    if (data != 0)
+        theFile.unmap((uchar *)data);
+}
+
+int
+ResultsColumnFile::write(const QString &filename, const QStringList &headings,
+                         const QVector<ResultsTableModel::Column> &columns)
+{
+    int numCol = columns.size();
+    int numRows = (numCol == 0) ? 0 : columns.at(0).values.size();
+    int numChunks = (numRows + ROWS_PER_CHUNK - 1)/ROWS_PER_CHUNK;
+
+    //
+    // the chunks are compressed first, the header holds their offsets from the end of it
+    //
+
+    QVector<QByteArray> chunks;
+    chunks.reserve(numCol*numChunks);
+    for (int col=0; col<numCol; col++) {
+        const QVector<double> &values = columns.at(col).values;
+        for (int k=0; k<numChunks; k++) {
+            int start = k*ROWS_PER_CHUNK;
+            int count = qMin(ROWS_PER_CHUNK, numRows-start);
+            chunks.append(qCompress((const uchar *)(values.constData()+start), count*int(sizeof(double))));
+        }
+    }
+
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << qint32(numCol) << qint32(numRows) << qint32(ROWS_PER_CHUNK) << headings;
+    for (int col=0; col<numCol; col++)
+        out << columns.at(col).dictionary;
+    qint64 offset = 0;
+    for (int i=0; i<chunks.size(); i++) {
+        out << offset << qint32(chunks.at(i).size());
+        offset += chunks.at(i).size();
+    }
+
+    QSaveFile theFile(filename);
+    if (!theFile.open(QIODevice::WriteOnly))
+        return -1;
+
+    quint32 byteOrderMark = BYTE_ORDER_MARK;
+    theFile.write(FILE_MAGIC, 8);
+    theFile.write((const char *)&byteOrderMark, sizeof(byteOrderMark));
+    theFile.write(header);
+    for (int i=0; i<chunks.size(); i++)
+        theFile.write(chunks.at(i));
+
+    return theFile.commit() ? 0 : -1;
+}
+
+int
+ResultsColumnFile::open(const QString &filename)
+{
+    theFile.setFileName(filename);
+    if (!theFile.open(QIODevice::ReadOnly))
+        return -1;
+
+    size = theFile.size();
+    const int start = 8 + sizeof(quint32);
+    if (size < start)
+        return -1;
+    data = theFile.map(0, size);
+    if (data == 0)
+        return -1;
+
+    // the values are stored as they are in memory, the file must have been written the same way
+    quint32 byteOrderMark;
+    memcpy(&byteOrderMark, data+8, sizeof(byteOrderMark));
+    if (memcmp(data, FILE_MAGIC, 8) != 0 || byteOrderMark != BYTE_ORDER_MARK)
+        return -1;
+
+    //
+    // the header, read in place
+    //
+
+    QByteArray header = QByteArray::fromRawData((const char *)data+start, size-start);
+    QDataStream in(header);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    qint32 numCol, rows, chunkRows;
+    in >> numCol >> rows >> chunkRows;
+    if (in.status() != QDataStream::Ok || numCol < 0 || rows < 0 || chunkRows <= 0 ||
+        chunkRows > INT_MAX/int(sizeof(double)))
+        return -1;
+    int numChunks = int((qint64(rows) + chunkRows - 1)/chunkRows);
+
+    // each column takes a heading and a dictionary (4 bytes at least) and 12 bytes a chunk in
+    // the header, counts the file is too small to hold are corrupt and not allocated
+    qint64 headerSize = size - start;
+    if (numCol > headerSize/8 || (numCol > 0 && numChunks > (headerSize/numCol - 8)/12))
+        return -1;
+    numRows = rows;
+    rowsPerChunk = chunkRows;
+
+    in >> theHeadings;
+    theDictionaries.resize(numCol);
+    for (int col=0; col<numCol; col++)
+        in >> theDictionaries[col];
+
+    theChunks.resize(numCol);
+    for (int col=0; col<numCol; col++) {
+        theChunks[col].resize(numChunks);
+        for (int k=0; k<numChunks; k++)
+            in >> theChunks[col][k].offset >> theChunks[col][k].size;
+    }
+    if (in.status() != QDataStream::Ok || theHeadings.size() != numCol)
+        return -1;
+
+    // the offsets made absolute and checked against the file
+    qint64 headerEnd = start + in.device()->pos();
+    for (int col=0; col<numCol; col++) {
+        for (int k=0; k<numChunks; k++) {
+            Chunk &theChunk = theChunks[col][k];
+            theChunk.offset += headerEnd;
+            if (theChunk.offset < headerEnd || theChunk.size < 0 || theChunk.offset + theChunk.size > size)
+                return -1;
+            // deflate expands at most about 1032 times, a chunk too small for its rows is corrupt
+            qint64 count = qMin(qint64(rowsPerChunk), numRows - k*qint64(rowsPerChunk));
+            if (count*qint64(sizeof(double)) > (qint64(theChunk.size) - 4)*1032)
+                return -1;
+        }
+    }
+
+    return 0;
+}
+
+int
+ResultsColumnFile::readColumn(int col, QVector<double> &values) const
+{
+    if (data == 0 || col < 0 || col >= theChunks.size())
+        return -1;
+
+    values.resize(numRows);
+    const QVector<Chunk> &chunks = theChunks.at(col);
+    for (int k=0; k<chunks.size(); k++) {
+        int start = k*rowsPerChunk;
+        int count = qMin(rowsPerChunk, numRows-start);
+        QByteArray raw = qUncompress(data + chunks.at(k).offset, chunks.at(k).size);
+        if (raw.size() != count*int(sizeof(double))) {
+            values.clear();
+            return -1;
+        }
+        memcpy(values.data()+start, raw.constData(), raw.size());
+    }
+
+    return 0;
+}
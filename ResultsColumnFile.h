@@ -0,0 +1,58 @@
+#ifndef RESULTS_COLUMN_FILE_H
+#define RESULTS_COLUMN_FILE_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <ResultsTableModel.h>
+
+//
+// the binary file the results table is saved to, in place of the values in the project json.
+// Each column is stored as chunks of ROWS_PER_CHUNK doubles compressed with qCompress, after a
+// header with the headings, the dictionaries of the string columns and the offset of every
+// chunk. Opening the file maps it and reads the header only, a column is uncompressed when it is
+// first asked for
+//
+//   "GMTRCOL1" | byte order mark | header (QDataStream) | compressed chunks
+//
+
+class ResultsColumnFile
+{
+public:
+    ResultsColumnFile();
+    ~ResultsColumnFile();
+
+    // writes the table, returns 0 if ok, -1 if not
+    static int write(const QString &filename, const QStringList &headings,
+                     const QVector<ResultsTableModel::Column> &columns);
+
+    // maps the file and reads its header, returns 0 if ok, -1 if not
+    int open(const QString &filename);
+
+    int getNumRows(void) const {return numRows;}
+    const QStringList &getHeadings(void) const {return theHeadings;}
+    const QStringList &getDictionary(int col) const {return theDictionaries.at(col);}
+
+    // uncompresses all the chunks of a column, returns 0 if ok, -1 if not
+    int readColumn(int col, QVector<double> &values) const;
+
+private:
+    struct Chunk
+    {
+        qint64 offset;
+        qint32 size;
+    };
+
+    QFile theFile;
+    const uchar *data;
+    qint64 size;
+
+    int numRows;
+    int rowsPerChunk;
+    QStringList theHeadings;
+    QVector<QStringList> theDictionaries;
+    QVector<QVector<Chunk> > theChunks;
+};
+
+#endif // RESULTS_COLUMN_FILE_H
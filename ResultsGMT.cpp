@@ -43,7 +43,12 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <QTabWidget>
 #include <QTextEdit>
-#include <MyTableWidget.h>
+#include <ResultsTableView.h>
+#include <ResultsTableModel.h>
+#include <DakotaTabParser.h>
+#include <SortedColumnCache.h>
+#include <DensityEngine.h>
+#include <ResultsColumnFile.h>
 #include <QDebug>
 #include <QHBoxLayout>
 #include <QColor>
@@ -52,6 +57,7 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <algorithm>
 
 #include <QMessageBox>
 #include <QVBoxLayout>
@@ -72,6 +78,9 @@ using namespace QtCharts;
 #include <QLabel>
 #include <QDirIterator>
 #include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QTimer>
 
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -79,17 +88,14 @@ using namespace QtCharts;
 #include <EarthquakeRecord.h>
 
 #include <ResponseWidget.h>
-#include <timeIntegrators.h>
-
-int CalcResponseSpectrum(const QVector<double> &periods,
-                         double dampingRatio,
-                         const char *integrator,
-                         const std::vector<double> &groundMotion,
-                         double time_step,
-                         QVector<double> &dispResponse,
-                         QVector<double> &accelResponse);
+#include <SpectrumEngine.h>
+#include <DakotaTabTailer.h>
 
 #define NUM_DIVISIONS 10
+#define NUM_PERCENTILES 3
+#define MAX_SPECTRA_PLOTTED 100
+#define SPECTRA_PER_UPDATE 20
+#define LIVE_REFRESH 5000
 
 
 ResultsGMT::ResultsGMT(QWidget *parent)
@@ -103,6 +109,27 @@ ResultsGMT::ResultsGMT(QWidget *parent)
     mLeft = true;
     col1 = 0;
     col2 = 0;
+    theGraphic = 0;
+    theTable = 0;
+    theSorted = 0;
+    theDensities = 0;
+    dakotaText = 0;
+    theSummary = 0;
+    connect(tabWidget, SIGNAL(currentChanged(int)), this, SLOT(onTabChanged(int)));
+
+    theSpectra = new SpectrumEngine(this);
+    connect(theSpectra, SIGNAL(spectrumReady(MotionSpectrum)), this, SLOT(onSpectrumReady(MotionSpectrum)));
+    connect(theSpectra, SIGNAL(finished()), this, SLOT(updateSpectrumStatistics()));
+
+    theTailer = new DakotaTabTailer(this);
+    connect(theTailer, SIGNAL(headingsRead(QStringList)), this, SLOT(onTabHeadingsRead(QStringList)));
+    connect(theTailer, SIGNAL(rowsRead(QVector<ResultsTableModel::Column>)), this, SLOT(onTabRowsRead(QVector<ResultsTableModel::Column>)));
+    connect(theTailer, SIGNAL(restarted()), this, SLOT(onTabRestarted()));
+
+    theLiveRefresh = new QTimer(this);
+    theLiveRefresh->setSingleShot(true);
+    theLiveRefresh->setInterval(LIVE_REFRESH);
+    connect(theLiveRefresh, SIGNAL(timeout()), this, SLOT(refreshLiveResults()));
 }
 
 ResultsGMT::~ResultsGMT()
@@ -110,9 +137,24 @@ ResultsGMT::~ResultsGMT()
 
 }
 
+//
+// the project file the results are saved with, the column file is kept next to it
+//
+
+void
+ResultsGMT::setProjectFile(const QString &fileName)
+{
+    theProjectFile = fileName;
+}
+
 
 void ResultsGMT::clear(void)
 {
+  // spectra still to come are for the response spectrum tab about to go, as are rows
+  theSpectra->cancel();
+  theTailer->stop();
+  theLiveRefresh->stop();
+
   //
   // get the tab widgets and delete them
   //
@@ -127,6 +169,10 @@ void ResultsGMT::clear(void)
 
     tabWidget->clear();
 
+    // the dakota output is kept for saving, it is not in a tab
+    delete dakotaText;
+    dakotaText = 0;
+
     //
     // clear any data we have stored
     // 
@@ -135,6 +181,20 @@ void ResultsGMT::clear(void)
     theNames.clear();
     theMeans.clear();
     theStdDevs.clear();
+    thePercentiles.clear();
+    theDataFile.clear();
+    theResultsDirectory.clear();
+    theGraphic = 0;
+    theSpectrumPeriods.clear();
+    theSpectrumStatistics.clear(0);
+    theSummaryEdits.clear();
+    theLiveSquares.clear();
+
+    // deleted with the tabs
+    theSummary = 0;
+    theTable = 0;
+    theSorted = 0;
+    theDensities = 0;
     
 }
 
@@ -152,6 +212,8 @@ ResultsGMT::outputToJSON(QJsonObject &jsonObject)
       return true;
 
     jsonObject["resultType"]=QString(tr("ResultsGMT"));
+    if (!theResultsDirectory.isEmpty())
+        jsonObject["resultsDirectory"]=theResultsDirectory;
 
     //
     // add summary data
@@ -170,7 +232,8 @@ ResultsGMT::outputToJSON(QJsonObject &jsonObject)
 
 
     // add general data
-    jsonObject["general"]=dakotaText->toPlainText();
+    if (dakotaText != 0)
+        jsonObject["general"]=dakotaText->toPlainText();
 
     //
     // add spreadsheet data
@@ -178,8 +241,8 @@ ResultsGMT::outputToJSON(QJsonObject &jsonObject)
 
     QJsonObject spreadsheetData;
 
-    int numCol = spreadsheet->columnCount();
-    int numRow = spreadsheet->rowCount();
+    int numCol = theTable->columnCount();
+    int numRow = theTable->rowCount();
 
     spreadsheetData["numRow"]=numRow;
     spreadsheetData["numCol"]=numCol;
@@ -191,13 +254,50 @@ ResultsGMT::outputToJSON(QJsonObject &jsonObject)
 
     spreadsheetData["headings"]=headingsArray;
 
+    //
+    // the values go to a binary column file (see ResultsColumnFile) next to the project file,
+    // <project>.gmtr, which the json names relative to the project so the two can be moved
+    // together; the file is written once for a set of results. With no project file the values
+    // stay in the json
+    //
+
+    QString dataFile;
+    if (!theProjectFile.isEmpty()) {
+        QFileInfo projectFile(theProjectFile);
+        dataFile = projectFile.completeBaseName() + QString(".gmtr");
+        QString dataPath = projectFile.absoluteDir().filePath(dataFile);
+
+        if (theDataFile != dataPath || !QFile::exists(dataPath)) {
+            QVector<ResultsTableModel::Column> columns(numCol);
+            for (int column = 0; column < numCol; ++column)
+                columns[column] = theTable->getColumn(column);
+
+            QApplication::setOverrideCursor(Qt::WaitCursor);
+            if (ResultsColumnFile::write(dataPath, theHeadings, columns) == 0)
+                theDataFile = dataPath;
+            else
+                dataFile.clear();
+            QApplication::restoreOverrideCursor();
+        }
+    }
+
+    if (!dataFile.isEmpty()) {
+        spreadsheetData["dataFile"]=dataFile;
+        spreadsheetData["dataPath"]=theDataFile;
+        jsonObject["spreadsheet"] = spreadsheetData;
+        return result;
+    }
+
+    // the column file could not be written, the values are kept in the json as before
     QJsonArray dataArray;
     QApplication::setOverrideCursor(Qt::WaitCursor);
     for (int row = 0; row < numRow; ++row) {
         for (int column = 0; column < numCol; ++column) {
-            QTableWidgetItem *theItem = spreadsheet->item(row,column);
-            QString textData = theItem->text();
-            dataArray.append(textData.toDouble());
+            const ResultsTableModel::Column &theColumn = theTable->getColumn(column);
+            if (theColumn.dictionary.isEmpty())
+                dataArray.append(theColumn.values.at(row));
+            else
+                dataArray.append(theColumn.dictionary.at(int(theColumn.values.at(row))-1).toDouble());
         }
     }
     QApplication::restoreOverrideCursor();
@@ -272,30 +372,63 @@ ResultsGMT::inputFromJSON(QJsonObject &jsonObject)
     // into a spreadsheet place all the data returned
     //
 
-    spreadsheet = new MyTableWidget();
+    spreadsheet = new ResultsTableView();
+    theTable = new ResultsTableModel(spreadsheet);
     QJsonObject spreadsheetData = jsonObject["spreadsheet"].toObject();
     int numRow = spreadsheetData["numRow"].toInt();
     int numCol = spreadsheetData["numCol"].toInt();
-    spreadsheet->setColumnCount(numCol);
-    spreadsheet->setRowCount(numRow);
 
     QJsonArray headingData= spreadsheetData["headings"].toArray();
     for (int i=0; i<numCol; i++) {
         theHeadings << headingData.at(i).toString();
     }
 
-    spreadsheet->setHorizontalHeaderLabels(theHeadings);
+    //
+    // the values are in a column file, only mapped here and read a column at a time as they are
+    // shown, or in older projects in the json a row at a time
+    //
+
+    QString dataFile = spreadsheetData["dataFile"].toString();
+    if (!dataFile.isEmpty() && QFileInfo(dataFile).isRelative() && !theProjectFile.isEmpty())
+        dataFile = QFileInfo(theProjectFile).absoluteDir().filePath(dataFile);
+
+    // where it was written, for a project saved elsewhere before its own column file was
+    QString dataPath = spreadsheetData["dataPath"].toString();
+    if (!dataFile.isEmpty() && !QFile::exists(dataFile) && !dataPath.isEmpty() && QFile::exists(dataPath))
+        dataFile = dataPath;
+
+    ResultsColumnFile *theFile = 0;
+    if (!dataFile.isEmpty()) {
+        theFile = new ResultsColumnFile();
+        if (theFile->open(dataFile) != 0 || theFile->getHeadings().size() != numCol) {
+            emit sendErrorMessage(QString("Could not read the results file: ") + dataFile);
+            delete theFile;
+            theFile = 0;
+            numRow = 0;
+        }
+    }
 
-    QJsonArray dataData= spreadsheetData["data"].toArray();
-    int dataCount =0;
-    for (int row =0; row<numRow; row++) {
+    if (theFile != 0) {
+        theTable->setColumnFile(theFile);
+        theDataFile = dataFile;
+    } else {
+        QJsonArray dataData= spreadsheetData["data"].toArray();
+        if (dataData.size() < numRow*numCol)
+            numRow = 0;
+        QVector<ResultsTableModel::Column> columns(numCol);
         for (int col=0; col<numCol; col++) {
-            QModelIndex index = spreadsheet->model()->index(row, col);
-            spreadsheet->model()->setData(index, dataData.at(dataCount).toDouble());
-            dataCount++;
+            QVector<double> &values = columns[col].values;
+            values.resize(numRow);
+            for (int row =0; row<numRow; row++)
+                values[row] = dataData.at(row*numCol + col).toDouble();
         }
+        theTable->setColumns(theHeadings, columns);
     }
-    spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    spreadsheet->setModel(theTable);
+
+    // the columns are read from the file as they are needed, the percentiles when they are shown
+    this->createColumnCaches();
+    theSummary = summary;
     connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
 
     //
@@ -328,6 +461,18 @@ ResultsGMT::inputFromJSON(QJsonObject &jsonObject)
     // add 3 Widgets to TabWidget
     //
 
+    //
+    // the spectra of the motions, if they are still there, from the cache unless the
+    // spectrum settings have changed
+    //
+
+    QString xLabel("Period");
+    QString yLabel("Displacement");
+    theGraphic = new ResponseWidget(xLabel, yLabel);
+    theGraphic->setXAxisLogarithmic(true);
+    theResultsDirectory = jsonObject["resultsDirectory"].toString();
+    this->startSpectra();
+
     tabWidget->addTab(theGraphic, tr("Response Spectrum"));
     tabWidget->addTab(summary,tr("Summary PGA"));
     tabWidget->addTab(widget, tr("PGA Values"));
@@ -337,55 +482,6 @@ ResultsGMT::inputFromJSON(QJsonObject &jsonObject)
 }
 
 
-static void merge_helper(double *input, int left, int right, double *scratch)
-{
-    // if one element: done  else: recursive call and then merge
-    if(right == left + 1) {
-        return;
-    } else {
-        int length = right - left;
-        int midpoint_distance = length/2;
-        /* l and r are to the positions in the left and right subarrays */
-        int l = left, r = left + midpoint_distance;
-
-        // sort each subarray
-        merge_helper(input, left, left + midpoint_distance, scratch);
-        merge_helper(input, left + midpoint_distance, right, scratch);
-
-        // merge the arrays together using scratch for temporary storage
-        for(int i = 0; i < length; i++) {
-            /* Check to see if any elements remain in the left array; if so,
-            * we check if there are any elements left in the right array; if
-            * so, we compare them.  Otherwise, we know that the merge must
-            * use take the element from the left array */
-            if(l < left + midpoint_distance &&
-                    (r == right || fmin(input[l], input[r]) == input[l])) {
-                scratch[i] = input[l];
-                l++;
-            } else {
-                scratch[i] = input[r];
-                r++;
-            }
-        }
-        // Copy the sorted subarray back to the input
-        for(int i = left; i < right; i++) {
-            input[i] = scratch[i - left];
-        }
-    }
-}
-
-static int mergesort(double *input, int size)
-{
-    double *scratch = new double[size];
-    if(scratch != NULL) {
-        merge_helper(input, 0, size, scratch);
-        delete [] scratch;
-        return 1;
-    } else {
-        return 0;
-    }
-}
-
 int ResultsGMT::processResults(QString filenameResults, QString filenameTab, QString inputFile) {
 
     qDebug() << "Processing Results.." << filenameTab;
@@ -402,6 +498,7 @@ int ResultsGMT::processResults(QString filenameResults, QString filenameTab, QSt
     QString xLabel("Period");
     QString yLabel("Displacement");
     theGraphic = new ResponseWidget(xLabel, yLabel);
+    theGraphic->setXAxisLogarithmic(true);
 
     QWidget *summaryWidget = new QWidget();
     QVBoxLayout *summaryLayout = new QVBoxLayout();
@@ -548,68 +645,29 @@ int ResultsGMT::processResults(QString filenameResults, QString filenameTab, QSt
     // now into a QTableWidget copy the random variable and edp's of each black box run
     //
 
-    spreadsheet = new MyTableWidget();
+    spreadsheet = new ResultsTableView();
+    theTable = new ResultsTableModel(spreadsheet);
 
-    // open file containing tab data
-    std::ifstream tabResults(filenameTab.toStdString().c_str());
-    if (!tabResults.is_open()) {
+    QVector<ResultsTableModel::Column> columns;
+    DakotaTabParser theParser;
+    if (theParser.parse(filenameTab, theHeadings, columns) < 0) {
         qDebug() << "Could not open file";
         return -1;
     }
 
-    //
-    // read first line and set headings (ignoring second column for now)
-    //
-
-    std::string inputLine;
-    std::getline(tabResults, inputLine);
-    std::istringstream iss(inputLine);
-    int colCount = 0;
-    theHeadings << "Run #";
-    do
-    {
-        std::string subs;
-        iss >> subs;
-        qDebug() << QString(subs.c_str());
-        if (colCount > 1) {
-            if (subs != "" && subs != " ") {
-                theHeadings << subs.c_str();
-            }
-        }
-        colCount++;
-    } while (iss);
-
     qDebug() << "SETTINGS: " << theHeadings << " " << theHeadings.count();
 
-    colCount = theHeadings.count();
-    spreadsheet->setColumnCount(colCount);
-    spreadsheet->setHorizontalHeaderLabels(theHeadings);
-
-    // now until end of file, read lines and place data into spreadsheet
-    int rowCount = 0;
-    while (std::getline(tabResults, inputLine)) {
-        std::istringstream is(inputLine);
-        int col=0;
-        spreadsheet->insertRow(rowCount);
-        for (int i=0; i<colCount+2; i++) {
-            std::string data;
-            is >> data;
-            if (i != 1) {
-                QModelIndex index = spreadsheet->model()->index(rowCount, col);
-                spreadsheet->model()->setData(index, data.c_str());
-                col++;
-            }
-        }
-        rowCount++;
-    }
-    tabResults.close();
+    int colCount = theHeadings.count();
+    int rowCount = columns.isEmpty() ? 0 : columns.at(0).values.size();
+    theTable->setColumns(theHeadings, columns);
+    spreadsheet->setModel(theTable);
+    this->requestPercentiles();
 
     if (rowCount == 0) {
       emit sendErrorMessage("Dakota FAILED to RUN Correctly");
       return -2;
     }
-   // rowCount;
-    spreadsheet->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
     connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
 
     //
@@ -653,48 +711,55 @@ int ResultsGMT::processResults(QString filenameResults, QString filenameTab, QSt
     QString resultsDirectory = tabFile.dir().absolutePath() + QDir::separator() + QString("Results");
     qDebug() << "looking at Results dir" << resultsDirectory;
 
-    QDirIterator it(resultsDirectory, QStringList() << "*.json");
-    while (it.hasNext()) {
-         QString resultFile = it.next();
-         this->addEarthquakeMotion(resultFile);
-    }
+    theResultsDirectory = resultsDirectory;
+    this->startSpectra();
 
 
     return 0;
 }
 
-void
-ResultsGMT::getColData(QVector<double> &data, int numRow, int col) {
-    bool ok;
-    double data0 = spreadsheet->item(0,col)->text().toDouble(&ok);
-    if (ok == true) {
-        for (int i=0; i<numRow; i++) {
-            QTableWidgetItem *item = spreadsheet->item(i,col);
-            data.append(item->text().toDouble());
-        }
-    } else { // it's a string create a map
-         QMap<QString, int> map;
-         int numDifferent = 1;
-         for (int i=0; i<numRow; i++) {
-             QTableWidgetItem *item = spreadsheet->item(i,col);
-             QString text = item->text();
-             if (map.contains(text))
-                 data.append(map.value(text));
-             else {
-                 data.append(numDifferent);
-                 map[text] = numDifferent++;
-             }
-         }
-    }
-    return;
-}
-
 void
 ResultsGMT::onSpreadsheetCellClicked(int row, int col)
 {
     qDebug() << "onSPreadSheetCellClicked() :" << row << " " << col;
     mLeft = spreadsheet->wasLeftKeyPressed();
 
+    // the highlight follows the columns, no cell is touched
+    if (mLeft == true)
+        col2 = col;
+    else
+        col1 = col;
+
+    theTable->setHighlightedColumns(col1, col2);
+    this->updateChart();
+}
+
+//
+// the chart of the columns picked: one against the other, or the frequency distribution or the
+// cumulative distribution of one
+//
+
+void
+ResultsGMT::updateChart(void)
+{
+    //
+    // a distribution is drawn from the column's density or sort once it is ready, waiting for it
+    // here would hold up the window: it is asked for and the chart drawn when it comes in
+    //
+
+    int rowCount = theTable->rowCount();
+    if (rowCount != 0 && col1 == col2) {
+        this->createColumnCaches();
+        if (mLeft == true && !theDensities->isReady(col1)) {
+            theDensities->request(col1);
+            return;
+        }
+        if (mLeft == false && !theSorted->isReady(col1)) {
+            theSorted->request(col1);
+            return;
+        }
+    }
+
     // create a new series
     chart->removeAllSeries();
     //chart->removeA
@@ -705,38 +770,18 @@ ResultsGMT::onSpreadsheetCellClicked(int row, int col)
     if (oldAxisY != 0)
         chart->removeAxis(oldAxisY);
 
-
-    // QScatterSeries *series;//= new QScatterSeries;
-
-    int oldCol = 0;
-    if (mLeft == true) {
-        oldCol= col2;
-        col2 = col;
-    } else {
-        oldCol= col1;
-        col1 = col;
-    }
-
-    int rowCount = spreadsheet->rowCount();
-
+    if (rowCount == 0)
+        return;
 
     if (col1 != col2) {
 
         QScatterSeries *series = new QScatterSeries;
         double minX, minY, maxX, maxY;
 
-        QVector<double> dataX;
-        QVector<double> dataY;
-        this->getColData(dataX, rowCount, col1);
-        this->getColData(dataY, rowCount, col2);
+        // the columns as loaded, string columns by their dictionary numbers
+        const QVector<double> &dataX = theTable->getColumn(col1).values;
+        const QVector<double> &dataY = theTable->getColumn(col2).values;
         for (int i=0; i<rowCount; i++) {
-            QTableWidgetItem *itemX = spreadsheet->item(i,col1);
-            QTableWidgetItem *itemY = spreadsheet->item(i,col2);
-            QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-            itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-            itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-            itemY->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
-	    
 	    double valX = dataX[i];
 	    double valY = dataY[i];
 	    if (i == 0) {
@@ -773,26 +818,14 @@ ResultsGMT::onSpreadsheetCellClicked(int row, int col)
 
     } else {
 
-        QVector<double> dataX;
-        this->getColData(dataX, rowCount, col1);
+        const QVector<double> &dataX = theTable->getColumn(col1).values;
 
         QLineSeries *series= new QLineSeries;
 
-        static double NUM_DIVISIONS_FOR_DIVISION = 10.0;
-        double *dataValues = new double[rowCount];
-        double histogram[NUM_DIVISIONS];
-        for (int i=0; i<NUM_DIVISIONS; i++)
-            histogram[i] = 0;
-
         double min = 0;
         double max = 0;
         for (int i=0; i<rowCount; i++) {
-            QTableWidgetItem *itemX = spreadsheet->item(i,col1);
-            QTableWidgetItem *itemOld = spreadsheet->item(i,oldCol);
-            itemOld->setData(Qt::BackgroundRole, QColor(Qt::white));
-            itemX->setData(Qt::BackgroundRole, QColor(Qt::lightGray));
             double value = dataX[i];
-            dataValues[i] =  value;
 
             if (i == 0) {
                 min = value;
@@ -805,55 +838,63 @@ ResultsGMT::onSpreadsheetCellClicked(int row, int col)
         }
         if (mLeft == true) {
 
-            // frequency distribution
-            double range = max-min;
-            double dRange = range/NUM_DIVISIONS_FOR_DIVISION;
+            //
+            // frequency distribution, in percent of the samples, with the bins of the column's
+            // density estimate and its kernel density scaled to the same percent per bin width
+            //
 
-            for (int i=0; i<rowCount; i++) {
-                // compute block belongs to, watch under and overflow due to numerics
-                int block = floor((dataValues[i]-min)/dRange);
-                if (block < 0) block = 0;
-                if (block > NUM_DIVISIONS-1) block = NUM_DIVISIONS-1;
-                histogram[block] += 1;
-            }
+            const DensityEstimate &theEstimate = theDensities->getDensity(col1);
+            int numBins = theEstimate.fraction.size();
+            double binStart = theEstimate.min;
+            double binWidth = theEstimate.binWidth;
 
             double maxPercent = 0;
-            for (int i=0; i<NUM_DIVISIONS; i++) {
-                histogram[i]/rowCount;
-                if (histogram[i] > maxPercent)
-                    maxPercent = histogram[i];
-            }
-            for (int i=0; i<NUM_DIVISIONS; i++) {
-                series->append(min+i*dRange, 0);
-                series->append(min+i*dRange, histogram[i]);
-                series->append(min+(i+1)*dRange, histogram[i]);
-                series->append(min+(i+1)*dRange, 0);
+            for (int i=0; i<numBins; i++) {
+                double percent = 100.0*theEstimate.fraction[i];
+                series->append(binStart+i*binWidth, 0);
+                series->append(binStart+i*binWidth, percent);
+                series->append(binStart+(i+1)*binWidth, percent);
+                series->append(binStart+(i+1)*binWidth, 0);
+                if (percent > maxPercent)
+                    maxPercent = percent;
             }
 
-            delete [] dataValues;
+            QLineSeries *densitySeries = new QLineSeries;
+            QVector<QPointF> densityPoints;
+            int numGrid = theEstimate.density.size();
+            densityPoints.reserve(numGrid);
+            for (int i=0; i<numGrid; i++) {
+                double percent = 100.0*binWidth*theEstimate.density[i];
+                densityPoints.append(QPointF(theEstimate.gridStart+i*theEstimate.gridStep, percent));
+                if (percent > maxPercent)
+                    maxPercent = percent;
+            }
+            densitySeries->replace(densityPoints);
 
             chart->addSeries(series);
+            chart->addSeries(densitySeries);
             QValueAxis *axisX = new QValueAxis();
             QValueAxis *axisY = new QValueAxis();
 
-            axisX->setRange(min, max);
-            axisY->setRange(0, maxPercent);
+            double gridEnd = theEstimate.gridStart + (numGrid-1)*theEstimate.gridStep;
+            axisX->setRange(std::min(binStart, theEstimate.gridStart), std::max(binStart+numBins*binWidth, gridEnd));
+            axisY->setRange(0, 1.05*maxPercent);
             axisY->setTitleText("Frequency %");
             axisX->setTitleText(theHeadings.at(col1));
             axisX->setTickCount(NUM_DIVISIONS+1);
             chart->setAxisX(axisX, series);
             chart->setAxisY(axisY, series);
+            densitySeries->attachAxis(axisX);
+            densitySeries->attachAxis(axisY);
     } else {
 
-            // cumulative distributionn
-            mergesort(dataValues, rowCount);
-
-            for (int i=0; i<rowCount; i++) {
-                series->append(dataValues[i], 1.0*i/rowCount);
+            // cumulative distributionn, from the column sorted once
+            const QVector<double> &sortedValues = theSorted->getSorted(col1).values;
+            int numSorted = sortedValues.size();
+            for (int i=0; i<numSorted; i++) {
+                series->append(sortedValues[i], 1.0*i/numSorted);
             }
 
-            delete [] dataValues;
-
             chart->addSeries(series);
             QValueAxis *axisX = new QValueAxis();
             QValueAxis *axisY = new QValueAxis();
@@ -921,6 +962,7 @@ ResultsGMT::createResultEDPWidget(QString &name, double mean, double stdDev, int
 
     firstLineEdit->setText(QString::number(mean));
     firstLineEdit->setDisabled(true);
+    theSummaryEdits.append(firstLineEdit);
     theMeans.append(mean);
     edpLayout->addWidget(firstWidget);
 
@@ -932,128 +974,290 @@ ResultsGMT::createResultEDPWidget(QString &name, double mean, double stdDev, int
      secondWidget = addLabeledLineEdit(QString("Max"), &secondLineEdit);
     secondLineEdit->setText(QString::number(stdDev));
     secondLineEdit->setDisabled(true);
+    theSummaryEdits.append(secondLineEdit);
     theStdDevs.append(stdDev);
     edpLayout->addWidget(secondWidget);
 
+    // the percentiles of the samples, filled in once the column is sorted
+    const char *percentileLabels[NUM_PERCENTILES] = {"5%", "Median", "95%"};
+    for (int i=0; i<NUM_PERCENTILES; i++) {
+        QLineEdit *percentileLineEdit;
+        QWidget *percentileWidget = addLabeledLineEdit(QString(percentileLabels[i]), &percentileLineEdit);
+        percentileLineEdit->setDisabled(true);
+        thePercentiles.append(percentileLineEdit);
+        edpLayout->addWidget(percentileWidget);
+    }
+
     edpLayout->addStretch();
 
     return edp;
 }
 
+//
+// the sorted columns and the densities of the table, made once for a table and kept as it is
+// added to; they go with the table
+//
+
 void
-ResultsGMT::addEarthquakeMotion(QString &name) {
+ResultsGMT::createColumnCaches(void)
+{
+    if (theSorted != 0)
+        return;
 
-    //
-    // open event file, obtain json object, read into an earthquake record, obtain response spectrum
-    //
+    theSorted = new SortedColumnCache(theTable, theTable);
+    connect(theSorted, SIGNAL(columnReady(int)), this, SLOT(onColumnSorted(int)));
+    theDensities = new DensityEngine(theTable, theTable);
+    connect(theDensities, SIGNAL(columnReady(int)), this, SLOT(onDensityReady(int)));
+}
 
-    currentMethod = "LinearInterpolation";
+//
+// the summary percentiles of each EDP come from its sorted column, the columns are sorted in the
+// background and the values filled in as each is done
+//
 
+void
+ResultsGMT::requestPercentiles(void)
+{
+    this->createColumnCaches();
+    for (int i=0; i<theNames.count(); i++)
+        theSorted->request(theHeadings.indexOf(theNames.at(i)));
+}
 
-    QFile file(name);
-    if(file.open(QFile::ReadOnly)) {
-        QString jsonText = QLatin1String(file.readAll());
-        QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonText.toUtf8());
-        QJsonObject jsonObj = jsonDoc.object();
-        //EarthquakeRecord *theMotion = new EarthquakeRecord();
-        //theMotion->inputFromJSON(jsonObj);
-        // get dT, return error if not there
-        QJsonValue theEvent = jsonObj["Events"];
-        if (theEvent.isNull() || theEvent.isUndefined()) {
-            return;
-        }
-        QJsonArray eventsArray = theEvent.toArray();
-        foreach (const QJsonValue &eventValue, eventsArray) {
-            QJsonObject eventObj = eventValue.toObject();
-            QJsonValue theValue = eventObj["dT"];
-            if (theValue.isNull() || theValue.isUndefined()) {
-                return;
-            }
-            double dT=theValue.toDouble();
-            theValue = eventObj["numSteps"];
-            if (theValue.isNull() || theValue.isUndefined()) {
-                return;
-            }
-            int numSteps =theValue.toInt();
-            qDebug() << numSteps << " " << dT;
+//
+// the summary of a loaded project is filled in the first time it is shown
+//
 
-            theValue = eventObj["pattern"];
-            if (theValue.isNull() || theValue.isUndefined()) {
-                qDebug() << QString("ERROR: addEarthquakeMotion - no pattern");
-                return;
-            }
-            QJsonArray patternsArray = theValue.toArray();
-            foreach (const QJsonValue &pattern, patternsArray) {
-                const QJsonObject patternObj = pattern.toObject();
-                theValue = patternObj["dof"];
-                if (theValue.isNull() || theValue.isUndefined()) {
-                    return;
-                }
-                int dof =theValue.toInt();
-                theValue = patternObj["timeSeries"];
-                if (theValue.isNull() || theValue.isUndefined()) {
-                    return;
-                }
-                QString patternTimeSeriesName =theValue.toString();
-                qDebug() << QString("dof timeSeries: ") << dof << " " << patternTimeSeriesName;
+void
+ResultsGMT::onTabChanged(int index)
+{
+    if (theSummary != 0 && tabWidget->widget(index) == theSummary)
+        this->requestPercentiles();
+}
 
-                theValue = eventObj["timeSeries"];
-                if (theValue.isNull() || theValue.isUndefined()) {
-                    qDebug() << QString("ERROR: addEarthquakeMotion - no timeSeries");
-                    return;
-                }
-                QJsonArray timeSeriesArray = theValue.toArray();
-                foreach (const QJsonValue &timeSeriesValue, timeSeriesArray) {
-                    QJsonObject timeSeriesObj = timeSeriesValue.toObject();
-                    theValue = timeSeriesObj["name"];
-                    if (theValue.isNull() || theValue.isUndefined()) {
-                        qDebug() << QString("ERROR: addEarthquakeMotion - no timeSeries name");
-                        return;
-                    }
-                    QString timeSeriesName =theValue.toString();
-                    if (timeSeriesName == patternTimeSeriesName) {
-                        qDebug() << "FOUND IT";
-                        theValue = timeSeriesObj["data"];
-                        if (theValue.isNull() || theValue.isUndefined()) {
-                            qDebug() << QString("ERROR: addEarthquakeMotion - no data array");
-                            return;
-                        }
-                        std::vector<double> data(numSteps);
-                        QJsonArray dataArray = theValue.toArray();
-                        for (int i=0; i<numSteps; i++)
-                            data.push_back(dataArray.at(i).toDouble());
-
-                        QVector<double> periods;
-                        periods.append(0.1);
-                        periods.append(0.5);
-                        periods.append(1.0);
-                        periods.append(2.0);
-                        const char *integrator="LinearInterpolation";
-                        double dT = 0.01;
-                        double dampRatio = 0.0;
-                        QVector<double> dispResponse;
-                        QVector<double> accelResponse;
-
-                        CalcResponseSpectrum(periods,
-                                             dampRatio,
-                                             integrator,
-                                             data,
-                                             dT,
-                                             dispResponse,
-                                             accelResponse);
-
-                        qDebug() << "RESULT: " << dispResponse;
-                        theGraphic->addData(dispResponse, periods);
-                        //for (auto val : dispResponse) {qDebug() << "ONE " << val;}
-
-                        break;
-                    } else
-                        qDebug() << timeSeriesName << " " << patternTimeSeriesName;
-                }
-            }
+void
+ResultsGMT::onColumnSorted(int col)
+{
+    const double percentiles[NUM_PERCENTILES] = {0.05, 0.5, 0.95};
 
-            qDebug() << numSteps << " " << dT;
-        }
+    for (int i=0; i<theNames.count(); i++) {
+        if (theHeadings.indexOf(theNames.at(i)) != col || thePercentiles.size() < (i+1)*NUM_PERCENTILES)
+            continue;
+        for (int j=0; j<NUM_PERCENTILES; j++)
+            thePercentiles.at(i*NUM_PERCENTILES+j)->setText(QString::number(theSorted->getPercentile(col, percentiles[j])));
+    }
+
+    if (col == col1 && col1 == col2 && mLeft == false && theSorted->isReady(col))
+        this->updateChart();
+}
+
+void
+ResultsGMT::onDensityReady(int col)
+{
+    if (col == col1 && col1 == col2 && mLeft == true && theDensities->isReady(col))
+        this->updateChart();
+}
+
+//
+// the spectra of the motions in the Results directory are computed in the background, each
+// plotted as it comes in
+//
+
+void
+ResultsGMT::startSpectra(void)
+{
+    if (theResultsDirectory.isEmpty())
+        return;
+
+    QStringList resultFiles;
+    QDirIterator it(theResultsDirectory, QStringList() << "*.json");
+    while (it.hasNext())
+         resultFiles << it.next();
+    theSpectra->start(resultFiles);
+}
+
+//
+// each spectrum goes into the statistics of the suite, only the first are drawn themselves so
+// a suite of thousands of motions is seen through its median and percentiles
+//
+
+void
+ResultsGMT::onSpectrumReady(const MotionSpectrum &theSpectrum)
+{
+    if (theSpectrumStatistics.getNumSpectra() == 0) {
+        theSpectrumPeriods = theSpectrum.periods;
+        theSpectrumStatistics.clear(theSpectrumPeriods.size());
+    }
+    if (theSpectrum.dispResponse.size() != theSpectrumPeriods.size())
+        return;
+
+    theSpectrumStatistics.add(theSpectrum.dispResponse.constData());
+    int numSpectra = theSpectrumStatistics.getNumSpectra();
+
+    if (numSpectra <= MAX_SPECTRA_PLOTTED) {
+        QVector<double> dispResponse = theSpectrum.dispResponse;
+        QVector<double> periods = theSpectrum.periods;
+        theGraphic->addData(dispResponse, periods);
+    }
+
+    if (numSpectra % SPECTRA_PER_UPDATE == 0)
+        this->updateSpectrumStatistics();
+}
 
+void
+ResultsGMT::updateSpectrumStatistics(void)
+{
+    int numSpectra = theSpectrumStatistics.getNumSpectra();
+    if (numSpectra == 0 || theGraphic == 0)
+        return;
+
+    int numPeriods = theSpectrumPeriods.size();
+    QVector<double> median(numPeriods), lower(numPeriods), upper(numPeriods);
+    double minDispersion = 0.0, maxDispersion = 0.0;
+    for (int i=0; i<numPeriods; i++) {
+        median[i] = theSpectrumStatistics.getQuantile(i, 0.5);
+        lower[i] = theSpectrumStatistics.getQuantile(i, 0.16);
+        upper[i] = theSpectrumStatistics.getQuantile(i, 0.84);
+        double dispersion = theSpectrumStatistics.getLogStdDev(i);
+        if (i == 0 || dispersion < minDispersion)
+            minDispersion = dispersion;
+        if (i == 0 || dispersion > maxDispersion)
+            maxDispersion = dispersion;
     }
+
+    theGraphic->setPercentiles(theSpectrumPeriods, median, lower, upper);
+    theGraphic->setCaption(QString("%1 motions, median and 16th, 84th percentiles in red (the first %2 motions drawn), "
+                                   "dispersion (standard deviation of ln) from %3 to %4")
+                           .arg(numSpectra).arg(qMin(numSpectra, MAX_SPECTRA_PLOTTED))
+                           .arg(minDispersion, 0, 'g', 3).arg(maxDispersion, 0, 'g', 3));
+}
+
+//
+// while dakota runs the rows of its dakotaTab file are shown as they are written: a summary of
+// every column, its mean and standard deviation kept up to date from the new rows alone, and the
+// chart and spreadsheet. processResults replaces all this once the run is done
+//
+
+void
+ResultsGMT::watchResults(QString filenameTab)
+{
+    this->clear();
+
+    mLeft = true;
+    col1 = 0;
+    col2 = 0;
+
+    theTailer->start(filenameTab);
+}
+
+void
+ResultsGMT::onTabRestarted(void)
+{
+    this->watchResults(theTailer->getFilename());
+}
+
+void
+ResultsGMT::onTabHeadingsRead(const QStringList &headings)
+{
+    theHeadings = headings;
+    int numCol = theHeadings.size();
+
+    // there is no dakota output until the run is done
+    dakotaText = new QTextEdit();
+    dakotaText->setReadOnly(true);
+
+    QWidget *summaryWidget = new QWidget();
+    QVBoxLayout *summaryLayout = new QVBoxLayout();
+    summaryWidget->setLayout(summaryLayout);
+    for (int col=1; col<numCol; col++) {
+        QString name = theHeadings.at(col);
+        summaryLayout->addWidget(this->createResultEDPWidget(name, 0.0, 0.0, 0));
+    }
+    summaryLayout->addStretch();
+    theLiveSquares.fill(0.0, theNames.size());
+
+    QScrollArea *summary = new QScrollArea;
+    summary->setWidgetResizable(true);
+    summary->setLineWidth(0);
+    summary->setFrameShape(QFrame::NoFrame);
+    summary->setWidget(summaryWidget);
+
+    spreadsheet = new ResultsTableView();
+    theTable = new ResultsTableModel(spreadsheet);
+    QVector<ResultsTableModel::Column> columns(numCol);
+    theTable->setColumns(theHeadings, columns);
+    spreadsheet->setModel(theTable);
+    connect(spreadsheet,SIGNAL(cellPressed(int,int)),this,SLOT(onSpreadsheetCellClicked(int,int)));
+
+    chart = new QChart();
+    QChartView *chartView = new QChartView(chart);
+    chartView->setRenderHint(QPainter::Antialiasing);
+    chartView->chart()->legend()->hide();
+    col2 = numCol-1;
+
+    QWidget *widget = new QWidget();
+    QVBoxLayout *layout = new QVBoxLayout(widget);
+    layout->addWidget(chartView, 1);
+    layout->addWidget(spreadsheet, 1);
+
+    tabWidget->addTab(summary,tr("Summary"));
+    tabWidget->addTab(widget, tr("PGA"));
+    tabWidget->adjustSize();
+}
+
+void
+ResultsGMT::onTabRowsRead(const QVector<ResultsTableModel::Column> &rows)
+{
+    if (theTable == 0)
+        return;
+
+    int first = theTable->rowCount();
+    theTable->appendRows(rows);
+    int numRows = theTable->rowCount();
+
+    // Welford's running mean and variance, over the rows just read
+    for (int i=0; i<theNames.count(); i++) {
+        const QVector<double> &values = theTable->getColumn(i+1).values;
+        double mean = theMeans.at(i);
+        double sumSquares = theLiveSquares.at(i);
+        for (int row=first; row<numRows; row++) {
+            double delta = values.at(row) - mean;
+            mean += delta/(row+1);
+            sumSquares += delta*(values.at(row) - mean);
+        }
+        theMeans[i] = mean;
+        theLiveSquares[i] = sumSquares;
+        theStdDevs[i] = (numRows > 1) ? sqrt(sumSquares/(numRows-1)) : 0.0;
+        theSummaryEdits.at(2*i)->setText(QString::number(mean));
+        theSummaryEdits.at(2*i+1)->setText(QString::number(theStdDevs.at(i)));
+    }
+
+    // a column file written before is missing these rows
+    theDataFile.clear();
+
+    //
+    // the percentiles and the chart are brought up to date at most every LIVE_REFRESH ms, the
+    // first rows at once
+    //
+
+    bool isFirst = (theSorted == 0);
+    this->createColumnCaches();
+    theSorted->invalidate();
+    theDensities->invalidate();
+    if (isFirst)
+        this->refreshLiveResults();
+    else if (!theLiveRefresh->isActive())
+        theLiveRefresh->start();
+
+    emit sendStatusMessage(QString("%1 runs done").arg(numRows));
+}
+
+void
+ResultsGMT::refreshLiveResults(void)
+{
+    if (theTable == 0)
+        return;
+
+    this->requestPercentiles();
+    theTable->setHighlightedColumns(col1, col2);
+    this->updateChart();
 }
@@ -41,14 +41,23 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
 #include <QtCharts/QChart>
 #include <SimCenterAppWidget.h>
+#include <SpectrumStatistics.h>
+#include <ResultsTableModel.h>
 
 using namespace QtCharts;
 
 class QTextEdit;
 class QTabWidget;
-class MyTableWidget;
+class ResultsTableView;
+class SortedColumnCache;
+class DensityEngine;
+class QLineEdit;
 class QVBoxLayout;
 class ResponseWidget;
+class SpectrumEngine;
+class DakotaTabTailer;
+class QTimer;
+struct MotionSpectrum;
 
 //class QChart;
 
@@ -63,6 +72,13 @@ public:
     bool inputFromJSON(QJsonObject &rvObject);
 
     int processResults(QString filenameResults, QString filenameTab, QString filenameInput);
+
+    // shows the rows of a dakotaTab file as they are written, until processResults or clear
+    void watchResults(QString filenameTab);
+
+    // the project file the results are read from and saved with
+    void setProjectFile(const QString &fileName);
+    const QString &getProjectFile(void) const {return theProjectFile;}
     QWidget *createResultEDPWidget(QString &name, double first, double second, int type);
 
 signals:
@@ -70,16 +86,31 @@ signals:
 public slots:
    void clear(void);
    void onSpreadsheetCellClicked(int, int);
+   void onColumnSorted(int);
+   void onSpectrumReady(const MotionSpectrum &theSpectrum);
+   void updateSpectrumStatistics(void);
+   void onTabHeadingsRead(const QStringList &headings);
+   void onTabRowsRead(const QVector<ResultsTableModel::Column> &rows);
+   void onTabRestarted(void);
+   void refreshLiveResults(void);
+   void onDensityReady(int);
+   void onTabChanged(int);
 
 private:
-   void getColData(QVector<double> &data, int numRow, int col);
-   void addEarthquakeMotion(QString &filename);
+   void createColumnCaches(void);
+   void requestPercentiles(void);
+   void startSpectra(void);
+   void updateChart(void);
 
    QVBoxLayout *layout;
 
    QTabWidget *tabWidget;
+   QWidget *theSummary;  // of a loaded project, its percentiles are read when it is first shown
    QTextEdit  *dakotaText;
-   MyTableWidget *spreadsheet;
+   ResultsTableView *spreadsheet;
+   ResultsTableModel *theTable;
+   SortedColumnCache *theSorted;
+   DensityEngine *theDensities;
    QChart *chart;
 
    int col1, col2;
@@ -89,10 +120,20 @@ private:
    QVector<QString>theNames;
    QVector<double>theMeans;
    QVector<double>theStdDevs;
+   QVector<QLineEdit *>thePercentiles;
+   QVector<QLineEdit *>theSummaryEdits;  // the two values of each EDP
+   QVector<double>theLiveSquares;        // for each EDP the sum of squares from the mean while a run is watched
    int dataType; // min/max or mean/stdDev
 
-   QString currentMethod;
+   QString theDataFile;  // the column file the results were saved to or loaded from
+   QString theProjectFile;  // the column file goes next to it
+   QString theResultsDirectory;  // the Results directory of the motions
    ResponseWidget *theGraphic;
+   SpectrumEngine *theSpectra;
+   DakotaTabTailer *theTailer;
+   QTimer *theLiveRefresh;
+   QVector<double> theSpectrumPeriods;
+   SpectrumStatistics theSpectrumStatistics;  // of all the spectra, not only those drawn
 
 };
 
@@ -0,0 +1,183 @@
+#include "ResultsTableModel.h"
+#include "ResultsColumnFile.h"
+#include <QColor>
+#include <QHash>
+#include <QDebug>
+
+ResultsTableModel::ResultsTableModel(QObject *parent)
+    : QAbstractTableModel(parent), theColumnFile(0), numRows(0), highlight1(-1), highlight2(-1)
+{
+
+}
+
+ResultsTableModel::~ResultsTableModel()
+{
+    delete theColumnFile;
+}
+
+void
+ResultsTableModel::setColumns(const QStringList &headings, QVector<Column> &columns)
+{
+    this->beginResetModel();
+    theHeadings = headings;
+    theColumns.swap(columns);
+    isLoaded.fill(true, theColumns.size());
+    delete theColumnFile;
+    theColumnFile = 0;
+    numRows = theColumns.isEmpty() ? 0 : theColumns.at(0).values.size();
+    highlight1 = -1;
+    highlight2 = -1;
+    this->endResetModel();
+}
+
+void
+ResultsTableModel::setColumnFile(ResultsColumnFile *theFile)
+{
+    this->beginResetModel();
+    theHeadings = theFile->getHeadings();
+    theColumns.clear();
+    theColumns.resize(theHeadings.size());
+    for (int col=0; col<theColumns.size(); col++)
+        theColumns[col].dictionary = theFile->getDictionary(col);
+    isLoaded.fill(false, theColumns.size());
+    delete theColumnFile;
+    theColumnFile = theFile;
+    numRows = theFile->getNumRows();
+    highlight1 = -1;
+    highlight2 = -1;
+    this->endResetModel();
+}
+
+const ResultsTableModel::Column &
+ResultsTableModel::getColumn(int col) const
+{
+    if (!isLoaded.at(col)) {
+        isLoaded[col] = true;
+        Column &theColumn = theColumns[col];
+        if (theColumnFile->readColumn(col, theColumn.values) < 0) {
+            qDebug() << "ResultsTableModel - could not read column" << col;
+            theColumn.values.fill(0.0, numRows);
+            theColumn.dictionary.clear();
+        }
+    }
+    return theColumns.at(col);
+}
+
+void
+ResultsTableModel::appendRows(const QVector<Column> &rows)
+{
+    int numNew = rows.isEmpty() ? 0 : rows.at(0).values.size();
+    if (numNew == 0 || rows.size() != theColumns.size())
+        return;
+
+    this->beginInsertRows(QModelIndex(), numRows, numRows+numNew-1);
+    for (int col=0; col<theColumns.size(); col++) {
+        this->getColumn(col); // loaded, if from a file
+        Column &theColumn = theColumns[col];
+        const Column &newColumn = rows.at(col);
+
+        if (theColumn.dictionary.isEmpty() && newColumn.dictionary.isEmpty()) {
+            theColumn.values += newColumn.values;
+            continue;
+        }
+
+        QHash<QString, int> textIndex;
+        for (int k=0; k<theColumn.dictionary.size(); k++)
+            textIndex.insert(theColumn.dictionary.at(k), k+1);
+
+        // the number of a text in the column dictionary, added if new
+        auto encode = [&theColumn, &textIndex](const QString &text) -> double {
+            QHash<QString, int>::const_iterator found = textIndex.constFind(text);
+            if (found != textIndex.constEnd())
+                return found.value();
+            theColumn.dictionary << text;
+            textIndex.insert(text, theColumn.dictionary.size());
+            return theColumn.dictionary.size();
+        };
+
+        if (theColumn.dictionary.isEmpty() && numRows != 0) {
+            // the column's first text, the numbers before it are encoded too
+            for (int j=0; j<numRows; j++)
+                theColumn.values[j] = encode(QString::number(theColumn.values.at(j), 'g', 10));
+            emit dataChanged(this->index(0, col), this->index(numRows-1, col));
+        }
+
+        for (int j=0; j<numNew; j++) {
+            double value = newColumn.values.at(j);
+            if (newColumn.dictionary.isEmpty())
+                theColumn.values.append(encode(QString::number(value, 'g', 10)));
+            else
+                theColumn.values.append(encode(newColumn.dictionary.at(int(value)-1)));
+        }
+    }
+    numRows += numNew;
+    this->endInsertRows();
+}
+
+void
+ResultsTableModel::clear(void)
+{
+    QVector<Column> noColumns;
+    this->setColumns(QStringList(), noColumns);
+}
+
+int
+ResultsTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : numRows;
+}
+
+int
+ResultsTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : theColumns.size();
+}
+
+QVariant
+ResultsTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    int col = index.column();
+    if (role == Qt::DisplayRole) {
+        const Column &theColumn = this->getColumn(col);
+        if (!theColumn.dictionary.isEmpty())
+            return theColumn.dictionary.at(int(theColumn.values.at(index.row())) - 1);
+        return QString::number(theColumn.values.at(index.row()), 'g', 10);
+    }
+
+    if (role == Qt::BackgroundRole && (col == highlight1 || col == highlight2))
+        return QColor(Qt::lightGray);
+
+    return QVariant();
+}
+
+QVariant
+ResultsTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (orientation == Qt::Horizontal)
+        return (section < theHeadings.size()) ? theHeadings.at(section) : QVariant();
+
+    return section+1;
+}
+
+void
+ResultsTableModel::setHighlightedColumns(int first, int second)
+{
+    int old1 = highlight1;
+    int old2 = highlight2;
+    highlight1 = first;
+    highlight2 = second;
+
+    // only the columns that change are repainted
+    int changed[4] = {old1, old2, first, second};
+    for (int i=0; i<4; i++) {
+        if (changed[i] >= 0 && changed[i] < theColumns.size() && numRows != 0)
+            emit dataChanged(this->index(0, changed[i]), this->index(numRows-1, changed[i]),
+                             QVector<int>() << Qt::BackgroundRole);
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef RESULTS_TABLE_MODEL_H
+#define RESULTS_TABLE_MODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+
+class ResultsColumnFile;
+
+//
+// the table of the sampling results (one row for each run of the dakotaTab file), kept as
+// columns of doubles; a cell is only turned into text when the view asks for it, so the cost of
+// a table is that of its values whatever its size. A column whose values are not all numbers
+// is dictionary encoded: each value is the number (from 1, in order of first appearance) of its
+// text in the dictionary, so every column can be plotted as it is. A table opened from a saved
+// ResultsColumnFile reads each column from it the first time the column is asked for
+//
+
+class ResultsTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    struct Column
+    {
+        QVector<double> values;
+        QStringList dictionary;   // non numeric columns only, the text of value i is entry i-1
+    };
+
+    explicit ResultsTableModel(QObject *parent = 0);
+    ~ResultsTableModel();
+
+    // takes over the columns, all of the same length
+    void setColumns(const QStringList &headings, QVector<Column> &columns);
+
+    // takes over an opened file, the columns are read from it as they are needed
+    void setColumnFile(ResultsColumnFile *theFile);
+
+    // adds rows after the last, one column of them for each column of the table; a column with
+    // text in the new rows or the old is dictionary encoded over both
+    void appendRows(const QVector<Column> &rows);
+    void clear(void);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    const QStringList &getHeadings(void) const {return theHeadings;}
+    const Column &getColumn(int col) const;
+    bool isNumeric(int col) const {return theColumns.at(col).dictionary.isEmpty();}
+
+    // the columns shown highlighted, -1 for none
+    void setHighlightedColumns(int first, int second);
+
+private:
+    QStringList theHeadings;
+    mutable QVector<Column> theColumns;
+    mutable QVector<bool> isLoaded;
+    ResultsColumnFile *theColumnFile;
+    int numRows;
+    int highlight1, highlight2;
+};
+
+#endif // RESULTS_TABLE_MODEL_H
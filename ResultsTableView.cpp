@@ -0,0 +1,31 @@
+#include "ResultsTableView.h"
+#include <QHeaderView>
+#include <QMouseEvent>
+
+ResultsTableView::ResultsTableView(QWidget *parent)
+    : QTableView(parent), leftKeyPressed(true)
+{
+    this->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    this->setWordWrap(false);
+
+    QHeaderView *rowHeader = this->verticalHeader();
+    rowHeader->setSectionResizeMode(QHeaderView::Fixed);
+    rowHeader->setDefaultSectionSize(this->fontMetrics().height() + 6);
+    this->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+}
+
+ResultsTableView::~ResultsTableView()
+{
+
+}
+
+void
+ResultsTableView::mousePressEvent(QMouseEvent *event)
+{
+    leftKeyPressed = (event->button() == Qt::LeftButton);
+    QTableView::mousePressEvent(event);
+
+    QModelIndex index = this->indexAt(event->pos());
+    if (index.isValid())
+        emit cellPressed(index.row(), index.column());
+}
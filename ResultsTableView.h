@@ -0,0 +1,33 @@
+#ifndef RESULTS_TABLE_VIEW_H
+#define RESULTS_TABLE_VIEW_H
+
+#include <QTableView>
+
+class QMouseEvent;
+
+//
+// the view of a ResultsTableModel: rows are of a fixed height so the view never measures them,
+// and only the visible cells are drawn. As with the spreadsheet it replaces, a press on a cell
+// is signalled with the row and column, and wasLeftKeyPressed() tells which button it was
+//
+
+class ResultsTableView : public QTableView
+{
+    Q_OBJECT
+public:
+    explicit ResultsTableView(QWidget *parent = 0);
+    ~ResultsTableView();
+
+    bool wasLeftKeyPressed(void) const {return leftKeyPressed;}
+
+signals:
+    void cellPressed(int row, int col);
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    bool leftKeyPressed;
+};
+
+#endif // RESULTS_TABLE_VIEW_H
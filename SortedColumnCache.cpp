@@ -0,0 +1,81 @@
+#include "SortedColumnCache.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cmath>
+
+//
+// the values are sorted with their rows, as pairs, so the sort works on one contiguous array;
+// nan is put last
+//
+
+static bool lessValue(const std::pair<double, int> &a, const std::pair<double, int> &b)
+{
+    if (std::isnan(a.first))
+        return false;
+    if (std::isnan(b.first))
+        return true;
+    return (a.first < b.first) || (a.first == b.first && a.second < b.second);
+}
+
+static SortedColumn sortColumn(const QVector<double> &values)
+{
+    int numRows = values.size();
+    std::vector<std::pair<double, int> > pairs(numRows);
+    for (int i=0; i<numRows; i++)
+        pairs[i] = std::make_pair(values.at(i), i);
+    std::sort(pairs.begin(), pairs.end(), lessValue);
+
+    SortedColumn result;
+    result.values.resize(numRows);
+    result.order.resize(numRows);
+    for (int i=0; i<numRows; i++) {
+        result.values[i] = pairs[i].first;
+        result.order[i] = pairs[i].second;
+    }
+    return result;
+}
+
+SortedColumnCache::SortedColumnCache(const ResultsTableModel *table, QObject *parent)
+    : ColumnJobCache<SortedColumn>(table, sortColumn, parent)
+{
+
+}
+
+double
+SortedColumnCache::getPercentile(int col, double p)
+{
+    const QVector<double> &values = this->getSorted(col).values;
+    int numRows = values.size();
+    if (numRows == 0)
+        return 0.0;
+
+    if (p <= 0.0)
+        return values.at(0);
+    if (p >= 1.0)
+        return values.at(numRows-1);
+
+    double position = p*(numRows-1);
+    int lower = int(position);
+    if (lower+1 >= numRows)
+        return values.at(lower);
+    double fraction = position - lower;
+    return values.at(lower) + fraction*(values.at(lower+1) - values.at(lower));
+}
+
+double
+SortedColumnCache::getCDF(int col, double value)
+{
+    const QVector<double> &values = this->getSorted(col).values;
+    if (values.isEmpty())
+        return 0.0;
+    int count = std::upper_bound(values.begin(), values.end(), value) - values.begin();
+    return double(count)/values.size();
+}
+
+int
+SortedColumnCache::getRank(int col, double value)
+{
+    const QVector<double> &values = this->getSorted(col).values;
+    return std::lower_bound(values.begin(), values.end(), value) - values.begin();
+}
@@ -0,0 +1,40 @@
+#ifndef SORTED_COLUMN_CACHE_H
+#define SORTED_COLUMN_CACHE_H
+
+#include <ColumnJobCache.h>
+
+//
+// a column in sorted order, the sorted values and the permutation (the row of each sorted value)
+//
+
+struct SortedColumn
+{
+    QVector<double> values;   // ascending
+    QVector<int> order;       // the row of each value
+};
+
+//
+// the columns of a ResultsTableModel in sorted order, each sorted in the background the first
+// time it is asked for (see ColumnJobCache). With the sorted values percentiles are found in O(1)
+// and the empirical cdf or the rank of a value in O(log n)
+//
+
+class SortedColumnCache : public ColumnJobCache<SortedColumn>
+{
+public:
+    explicit SortedColumnCache(const ResultsTableModel *theTable, QObject *parent = 0);
+
+    // these wait for the column to be sorted if it is not yet
+    const SortedColumn &getSorted(int col) {return this->get(col);}
+
+    // the p-th percentile (p in [0,1]) interpolated between the closest ranks
+    double getPercentile(int col, double p);
+
+    // the fraction of the values <= value
+    double getCDF(int col, double value);
+
+    // the number of values < value, the rank (from 0) the value would have
+    int getRank(int col, double value);
+};
+
+#endif // SORTED_COLUMN_CACHE_H
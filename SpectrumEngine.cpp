@@ -0,0 +1,365 @@
+#include "SpectrumEngine.h"
+#include <TimeSeriesFile.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QDebug>
+#include <math.h>
+
+int CalcResponseSpectrum(const QVector<double> &periods,
+                         double dampingRatio,
+                         const char *integrator,
+                         const std::vector<double> &groundMotion,
+                         double time_step,
+                         QVector<double> &dispResponse,
+                         QVector<double> &accelResponse);
+
+#define CACHE_VERSION 1
+
+SpectrumParameters
+SpectrumParameters::fromSettings(void)
+{
+    QSettings settings;
+    settings.beginGroup("spectrum");
+    double minPeriod = settings.value("minPeriod", 0.01).toDouble();
+    double maxPeriod = settings.value("maxPeriod", 10.0).toDouble();
+    int numPeriods = settings.value("numPeriods", 200).toInt();
+
+    SpectrumParameters theParameters;
+    theParameters.dampingRatio = settings.value("dampingRatio", 0.05).toDouble();
+    theParameters.integrator = settings.value("integrator", "LinearInterpolation").toString();
+    settings.endGroup();
+
+    // the integrators need 0 <= damping < 1 and periods > 0
+    if (theParameters.dampingRatio < 0.0 || theParameters.dampingRatio >= 1.0)
+        theParameters.dampingRatio = 0.05;
+    if (minPeriod <= 0.0)
+        minPeriod = 0.01;
+    if (maxPeriod < minPeriod)
+        maxPeriod = minPeriod;
+    if (numPeriods < 1)
+        numPeriods = 1;
+
+    theParameters.periods.resize(numPeriods);
+    double ratio = (numPeriods > 1) ? log(maxPeriod/minPeriod)/(numPeriods-1) : 0.0;
+    for (int i=0; i<numPeriods; i++)
+        theParameters.periods[i] = minPeriod*exp(i*ratio);
+
+    return theParameters;
+}
+
+//
+// the cache key, a hash of the ground motion as stored in memory, its time step and the parameters
+//
+
+static QString
+getCacheKey(const std::vector<double> &data, double dT, const SpectrumParameters &theParameters)
+{
+    QCryptographicHash theHash(QCryptographicHash::Sha1);
+    int version = CACHE_VERSION;
+    theHash.addData((const char *)&version, sizeof(version));
+    theHash.addData((const char *)data.data(), int(data.size()*sizeof(double)));
+    theHash.addData((const char *)&dT, sizeof(dT));
+    theHash.addData((const char *)&theParameters.dampingRatio, sizeof(double));
+    theHash.addData(theParameters.integrator.toUtf8());
+    theHash.addData((const char *)theParameters.periods.constData(), theParameters.periods.size()*int(sizeof(double)));
+    return QString::fromLatin1(theHash.result().toHex());
+}
+
+static bool
+readCachedSpectrum(const QString &filename, MotionSpectrum &theSpectrum)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_0);
+    qint32 version;
+    in >> version >> theSpectrum.dispResponse >> theSpectrum.accelResponse;
+    int numPeriods = theSpectrum.periods.size();
+    return in.status() == QDataStream::Ok && version == CACHE_VERSION
+        && theSpectrum.dispResponse.size() == numPeriods && theSpectrum.accelResponse.size() == numPeriods;
+}
+
+static void
+writeCachedSpectrum(const QString &filename, const MotionSpectrum &theSpectrum)
+{
+    // written aside and renamed, another thread may be writing the same record
+    QSaveFile file(filename);
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << qint32(CACHE_VERSION) << theSpectrum.dispResponse << theSpectrum.accelResponse;
+    file.commit();
+}
+
+//
+// keeps the cache within bounds, read from the settings (group "spectrum"): the spectra written
+// more than cacheDays ago are removed, then the oldest of the rest until they take no more than
+// cacheSizeMB. A spectrum read from the cache is not written again, so it is the oldest computed
+// that go first, not the least used
+//
+
+static void
+pruneCache(const QString &directory)
+{
+    QSettings settings;
+    settings.beginGroup("spectrum");
+    qint64 maxSize = settings.value("cacheSizeMB", 256).toLongLong()*1024*1024;
+    int maxDays = settings.value("cacheDays", 30).toInt();
+    settings.endGroup();
+
+    QDir theDirectory(directory);
+    QFileInfoList files = theDirectory.entryInfoList(QStringList() << "*.spectrum", QDir::Files, QDir::Time);
+    QDateTime oldest = QDateTime::currentDateTime().addDays(-maxDays);
+
+    // newest first, so once one is too old or over the size all those after it are too
+    qint64 size = 0;
+    for (int i=0; i<files.size(); i++) {
+        const QFileInfo &theFile = files.at(i);
+        size += theFile.size();
+        if ((maxDays > 0 && theFile.lastModified() < oldest) || (maxSize > 0 && size > maxSize))
+            QFile::remove(theFile.absoluteFilePath());
+    }
+}
+
+QVector<MotionSpectrum>
+computeMotionSpectra(const QString &name,
+                     const SpectrumParameters &theParameters,
+                     const QString &cacheDirectory)
+{
+    QVector<MotionSpectrum> theSpectra;
+
+    //
+    // open event file, obtain json object, for the timeSeries of each pattern the response spectrum
+    //
+
+    QFile file(name);
+    if (!file.open(QFile::ReadOnly))
+        return theSpectra;
+
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll());
+    QJsonObject jsonObj = jsonDoc.object();
+
+    QJsonValue theEvent = jsonObj["Events"];
+    if (theEvent.isNull() || theEvent.isUndefined()) {
+        return theSpectra;
+    }
+    QJsonArray eventsArray = theEvent.toArray();
+    foreach (const QJsonValue &eventValue, eventsArray) {
+        QJsonObject eventObj = eventValue.toObject();
+        QJsonValue theValue = eventObj["dT"];
+        if (theValue.isNull() || theValue.isUndefined()) {
+            return theSpectra;
+        }
+        double dT=theValue.toDouble();
+        if (dT <= 0.0) {
+            qDebug() << QString("ERROR: computeMotionSpectra - bad dT in ") << name;
+            return theSpectra;
+        }
+        theValue = eventObj["numSteps"];
+        if (theValue.isNull() || theValue.isUndefined()) {
+            return theSpectra;
+        }
+        int numSteps =theValue.toInt();
+        QJsonObject unitsObj = eventObj["units"].toObject();
+        QByteArray lengthUnit = unitsObj["length"].toString().toLatin1();
+        QByteArray timeUnit = unitsObj["time"].toString().toLatin1();
+
+        theValue = eventObj["pattern"];
+        if (theValue.isNull() || theValue.isUndefined()) {
+            qDebug() << QString("ERROR: computeMotionSpectra - no pattern in ") << name;
+            return theSpectra;
+        }
+        QJsonArray patternsArray = theValue.toArray();
+        foreach (const QJsonValue &pattern, patternsArray) {
+            const QJsonObject patternObj = pattern.toObject();
+            theValue = patternObj["dof"];
+            if (theValue.isNull() || theValue.isUndefined()) {
+                return theSpectra;
+            }
+            int dof =theValue.toInt();
+            theValue = patternObj["timeSeries"];
+            if (theValue.isNull() || theValue.isUndefined()) {
+                return theSpectra;
+            }
+            QString patternTimeSeriesName =theValue.toString();
+
+            theValue = eventObj["timeSeries"];
+            if (theValue.isNull() || theValue.isUndefined()) {
+                qDebug() << QString("ERROR: computeMotionSpectra - no timeSeries in ") << name;
+                return theSpectra;
+            }
+            QJsonArray timeSeriesArray = theValue.toArray();
+            foreach (const QJsonValue &timeSeriesValue, timeSeriesArray) {
+                QJsonObject timeSeriesObj = timeSeriesValue.toObject();
+                theValue = timeSeriesObj["name"];
+                if (theValue.isNull() || theValue.isUndefined()) {
+                    qDebug() << QString("ERROR: computeMotionSpectra - no timeSeries name in ") << name;
+                    return theSpectra;
+                }
+                if (theValue.toString() != patternTimeSeriesName)
+                    continue;
+
+                std::vector<double> data;
+                QString dataFile = timeSeriesObj["dataFile"].toString();
+                if (!dataFile.isEmpty()) {
+                    // binary sidecar next to the event file, mapped instead of parsed
+                    QString dataPath = QFileInfo(name).absoluteDir().filePath(dataFile);
+                    TimeSeriesFile theFile;
+                    if (theFile.open(dataPath.toLocal8Bit().constData()) < 0) {
+                        qDebug() << QString("ERROR: computeMotionSpectra - could not read ") << dataPath;
+                        return theSpectra;
+                    }
+                    if (!theFile.hasUnits(lengthUnit.constData(), timeUnit.constData())) {
+                        qDebug() << QString("ERROR: computeMotionSpectra - units of ") << dataPath << QString(" differ from those of the event");
+                        return theSpectra;
+                    }
+                    data.assign(theFile.getData(), theFile.getData() + theFile.getNumSteps());
+                } else {
+                    theValue = timeSeriesObj["data"];
+                    if (theValue.isNull() || theValue.isUndefined()) {
+                        qDebug() << QString("ERROR: computeMotionSpectra - no data array in ") << name;
+                        return theSpectra;
+                    }
+                    QJsonArray dataArray = theValue.toArray();
+                    int numData = std::min(numSteps, dataArray.size());
+                    data.reserve(numData);
+                    for (int i=0; i<numData; i++)
+                        data.push_back(dataArray.at(i).toDouble());
+                }
+
+                MotionSpectrum theSpectrum;
+                theSpectrum.name = name;
+                theSpectrum.dof = dof;
+                theSpectrum.periods = theParameters.periods;
+
+                QString cacheFile;
+                if (!cacheDirectory.isEmpty()) {
+                    cacheFile = cacheDirectory + QString("/") + getCacheKey(data, dT, theParameters) + QString(".spectrum");
+                    if (readCachedSpectrum(cacheFile, theSpectrum)) {
+                        theSpectra.append(theSpectrum);
+                        break;
+                    }
+                }
+
+                if (CalcResponseSpectrum(theSpectrum.periods,
+                                         theParameters.dampingRatio,
+                                         theParameters.integrator.toLatin1().constData(),
+                                         data,
+                                         dT,
+                                         theSpectrum.dispResponse,
+                                         theSpectrum.accelResponse) == 0) {
+                    if (!cacheFile.isEmpty())
+                        writeCachedSpectrum(cacheFile, theSpectrum);
+                    theSpectra.append(theSpectrum);
+                }
+
+                break;
+            }
+        }
+    }
+
+    return theSpectra;
+}
+
+//
+// the function mapped over the event files, carrying the parameters to the threads
+//
+
+struct ComputeSpectra
+{
+    typedef QVector<MotionSpectrum> result_type;
+
+    ComputeSpectra(const SpectrumParameters &parameters, const QString &directory)
+        : theParameters(parameters), cacheDirectory(directory) {}
+
+    QVector<MotionSpectrum> operator()(const QString &filename) const {
+        return computeMotionSpectra(filename, theParameters, cacheDirectory);
+    }
+
+    SpectrumParameters theParameters;
+    QString cacheDirectory;
+};
+
+SpectrumEngine::SpectrumEngine(QObject *parent)
+    : QObject(parent), theWatcher(0)
+{
+
+}
+
+SpectrumEngine::~SpectrumEngine()
+{
+    this->cancel();
+}
+
+void
+SpectrumEngine::start(const QStringList &filenames)
+{
+    this->cancel();
+
+    SpectrumParameters theParameters = SpectrumParameters::fromSettings();
+    QString cacheDirectory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QString("/spectra");
+    if (!QDir().mkpath(cacheDirectory))
+        cacheDirectory.clear();
+    else
+        pruneCache(cacheDirectory);
+
+    // the watcher is connected before it is given the future so no result is missed
+    theWatcher = new QFutureWatcher<QVector<MotionSpectrum> >(this);
+    connect(theWatcher, SIGNAL(resultReadyAt(int)), this, SLOT(onResultReadyAt(int)));
+    connect(theWatcher, SIGNAL(finished()), this, SLOT(onFinished()));
+    theWatcher->setFuture(QtConcurrent::mapped(filenames, ComputeSpectra(theParameters, cacheDirectory)));
+}
+
+void
+SpectrumEngine::cancel(void)
+{
+    if (theWatcher == 0)
+        return;
+
+    //
+    // the files not started are dropped; those being read finish on their own but, with the
+    // watcher disconnected, nothing more is heard from them
+    //
+
+    theWatcher->disconnect(this);
+    theWatcher->cancel();
+    theWatcher->deleteLater();
+    theWatcher = 0;
+}
+
+bool
+SpectrumEngine::isRunning(void) const
+{
+    return theWatcher != 0 && theWatcher->isRunning();
+}
+
+void
+SpectrumEngine::onResultReadyAt(int index)
+{
+    const QVector<MotionSpectrum> theSpectra = theWatcher->resultAt(index);
+    for (int i=0; i<theSpectra.size(); i++)
+        emit spectrumReady(theSpectra.at(i));
+}
+
+void
+SpectrumEngine::onFinished(void)
+{
+    emit finished();
+}
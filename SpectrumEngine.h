@@ -0,0 +1,76 @@
+#ifndef SPECTRUM_ENGINE_H
+#define SPECTRUM_ENGINE_H
+
+#include <QObject>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+template <typename T> class QFutureWatcher;
+
+//
+// the response spectrum of a motion, one for each timeSeries an event pattern applies
+//
+
+struct MotionSpectrum
+{
+    QString name;                  // the event file
+    int dof;
+    QVector<double> periods;
+    QVector<double> dispResponse;
+    QVector<double> accelResponse;
+};
+
+//
+// what the spectra are computed for, read from the application settings (group "spectrum"): a
+// grid of numPeriods periods spaced evenly in log between minPeriod and maxPeriod, the damping
+// ratio and the time integrator (see calcResponseSpectrum)
+//
+
+struct SpectrumParameters
+{
+    QVector<double> periods;
+    double dampingRatio;
+    QString integrator;
+
+    static SpectrumParameters fromSettings(void);
+};
+
+// reads an event file and computes the spectra of its motions, safe to call from any thread. If
+// cacheDirectory is not empty a spectrum is looked up there first, under a hash of the record
+// and the parameters, and saved there once computed
+QVector<MotionSpectrum> computeMotionSpectra(const QString &filename,
+                                             const SpectrumParameters &theParameters,
+                                             const QString &cacheDirectory);
+
+//
+// computes the spectra of a set of event files on the thread pool, several files at a time, and
+// hands each on as soon as its file is done; starting again, or cancelling, drops the files not
+// yet started and any result still to come from them
+//
+
+class SpectrumEngine : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SpectrumEngine(QObject *parent = 0);
+    ~SpectrumEngine();
+
+    // the parameters are read from the settings, and the cache pruned, when the files are started
+    void start(const QStringList &filenames);
+    void cancel(void);
+    bool isRunning(void) const;
+
+signals:
+    void spectrumReady(const MotionSpectrum &theSpectrum);
+    void finished(void);
+
+private slots:
+    void onResultReadyAt(int index);
+    void onFinished(void);
+
+private:
+    QFutureWatcher<QVector<MotionSpectrum> > *theWatcher;
+};
+
+#endif // SPECTRUM_ENGINE_H
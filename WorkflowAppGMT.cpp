@@ -56,6 +56,8 @@ UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QTimer>
 #include <RemoteService.h>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
@@ -341,9 +343,72 @@ WorkflowAppGMT::selectionChangedSlot(const QItemSelection & /*newSelection*/, co
 }
 
 
+//
+// a save: the inputs and the results. The column file of the results is written next to the
+// project file, which the main window only settles once the json is written (on a first save or
+// a save as), so that is checked again once it is done
+//
+
 bool
 WorkflowAppGMT::outputToJSON(QJsonObject &jsonObjectTop) {
 
+    this->outputInputsToJSON(jsonObjectTop);
+
+    QJsonObject jsonObjectResults;
+    theResults->outputToJSON(jsonObjectResults);
+    if (!jsonObjectResults.isEmpty())
+        jsonObjectTop["Results"] = jsonObjectResults;
+
+    QTimer::singleShot(0, this, SLOT(onProjectSaved()));
+
+    return true;
+}
+
+//
+// the project file the main window saved to: if the results were written for another one, on a
+// first save or a save as, they are written into it again with a column file next to it
+//
+
+void
+WorkflowAppGMT::onProjectSaved(void) {
+
+    QString fileName = this->window()->windowFilePath();
+    if (!QFileInfo(fileName).isFile() || fileName == theResults->getProjectFile())
+        return;
+
+    theResults->setProjectFile(fileName);
+
+    QJsonObject jsonObjectResults;
+    theResults->outputToJSON(jsonObjectResults);
+    if (jsonObjectResults.isEmpty())
+        return;
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        emit errorMessage(QString("Could Not Open File: ") + fileName);
+        return;
+    }
+    QJsonObject jsonObj = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+    if (jsonObj.isEmpty())
+        return;
+
+    jsonObj["Results"] = jsonObjectResults;
+    if (!file.open(QFile::WriteOnly | QFile::Text)) {
+        emit errorMessage(QString("Could Not Write File: ") + fileName);
+        return;
+    }
+    file.write(QJsonDocument(jsonObj).toJson());
+    file.close();
+}
+
+//
+// the inputs alone, what a run is set up from
+//
+
+void
+WorkflowAppGMT::outputInputsToJSON(QJsonObject &jsonObjectTop) {
+
     //
     // get each of the main widgets to output themselves
     //
@@ -366,10 +431,19 @@ WorkflowAppGMT::outputToJSON(QJsonObject &jsonObjectTop) {
     jsonObjectEDP["Application"] = "StandardGMT_EDP",
     apps["EDP"] = jsonObjectEDP;
 
+    //
+    // ExtractPGAClient hands each sample to a persistent ExtractPGA worker, sparing the start of an
+    // application per sample; it writes the PGA alone, all the EDP template has unless the BIM asks
+    // for more measures. It is used if the setting "simulation/persistentWorker" is on
+    //
+
+    QSettings settings;
+    bool persistentWorker = settings.value("simulation/persistentWorker", false).toBool();
+
     QJsonObject jsonObjectSIM;
     QJsonObject dataObjSIM;
     jsonObjectSIM["ApplicationData"] = dataObjSIM;
-    jsonObjectSIM["Application"] = "ExtractPGA",
+    jsonObjectSIM["Application"] = persistentWorker ? "ExtractPGAClient" : "ExtractIMs",
     apps["Simulation"] = jsonObjectSIM;
 
     theUQ_Method->outputToJSON(jsonObjectUQ);
@@ -390,8 +464,6 @@ WorkflowAppGMT::outputToJSON(QJsonObject &jsonObjectTop) {
     QJsonArray resultFiles;
     resultFiles.append(QJsonValue("EVENT.json"));
     jsonObjectTop["ResultFiles"] = resultFiles;
-
-    return true;
 }
 
 
@@ -408,6 +480,8 @@ void
 WorkflowAppGMT::clear(void)
 {
     theLoc->clear();
+    theResults->clear();
+    theResults->setProjectFile(QString());
 }
 
 bool
@@ -465,6 +539,12 @@ WorkflowAppGMT::inputFromJSON(QJsonObject &jsonObject)
     theRVs->inputFromJSON(jsonObject);
     theRunWidget->inputFromJSON(jsonObject);
 
+    // the column file of the results is found relative to the project file, set by loadFile
+    if (jsonObject.contains("Results")) {
+        QJsonObject jsonObjResults = jsonObject["Results"].toObject();
+        theResults->inputFromJSON(jsonObjResults);
+    }
+
     return true;
 }
 
@@ -560,7 +640,7 @@ WorkflowAppGMT::setUpForApplicationRun(QString &workingDir, QString &subDir) {
         return;
     }
     QJsonObject json;
-    this->outputToJSON(json);
+    this->outputInputsToJSON(json);
 
     json["runDir"]=tmpDirectory;
     json["WorkflowType"]="Building Simulation";
@@ -572,6 +652,10 @@ WorkflowAppGMT::setUpForApplicationRun(QString &workingDir, QString &subDir) {
 
     statusMessage("SetUp Done .. Now starting application");
 
+    // the rows dakota writes are shown as the run goes, when it runs here
+    if (currentApp == localApp)
+        theResults->watchResults(tmpDirectory + QDir::separator() + QString("dakotaTab.out"));
+
     emit setUpForApplicationRunDone(tmpDirectory, inputFile);
 }
 
@@ -605,6 +689,7 @@ WorkflowAppGMT::loadFile(const QString fileName){
     //
 
     this->clear();
+    theResults->setProjectFile(fileName);
     this->inputFromJSON(jsonObj);
 }
 
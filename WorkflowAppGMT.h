@@ -98,7 +98,12 @@ public slots:
 
     void loadFile(QString filename);
 
+private slots:
+    void onProjectSaved(void);
+
 private:
+    void outputInputsToJSON(QJsonObject &rvObject);
+
     QHBoxLayout *horizontalLayout;
     QTreeView *treeView;
     QStandardItemModel *standardModel;
@@ -147,6 +147,35 @@ def main(run_type, inputFile, applicationsRegistry):
             raise WorkFlowInputError('Need an Events Entry in Applications')
 
 
+        #
+        # the EDP and Simulation applications, each run after the event in the driver; a workflow
+        # without them runs the event alone
+        #
+
+        edpAppExe = None
+        if 'EDP' in available_apps:
+            edpApp = available_apps['EDP']
+            edpApplication = edpApp['Application']
+            edpAppData = edpApp.get('ApplicationData', dict())
+            if edpApplication in Applications.get('EDPApplications', dict()).keys():
+                edpAppExe = Applications['EDPApplications'].get(edpApplication)
+                edpAppExeLocal = posixpath.join(localAppDir,edpAppExe)
+                edpAppExeRemote = posixpath.join(remoteAppDir,edpAppExe)
+            else:
+                raise WorkFlowInputError('EDP application {} not in registry'.format(edpApplication))
+
+        simAppExe = None
+        if 'Simulation' in available_apps:
+            simApp = available_apps['Simulation']
+            simApplication = simApp['Application']
+            simAppData = simApp.get('ApplicationData', dict())
+            if simApplication in Applications.get('SimulationApplications', dict()).keys():
+                simAppExe = Applications['SimulationApplications'].get(simApplication)
+                simAppExeLocal = posixpath.join(localAppDir,simAppExe)
+                simAppExeRemote = posixpath.join(remoteAppDir,simAppExe)
+            else:
+                raise WorkFlowInputError('Simulation application {} not in registry'.format(simApplication))
+
         if 'UQ' in available_apps:
             uqApp = available_apps['UQ']
 
@@ -214,6 +243,51 @@ def main(run_type, inputFile, applicationsRegistry):
         command, result, returncode = runApplication(eventAppDataList)
         log_output.append([command, result, returncode])
 
+        #
+        # the EDP template is written once, here, and again in the driver for each sample; the
+        # simulation application then writes the EDPs and the results.out dakota reads
+        #
+
+        edpFILE = 'EDP.json'
+        resultsFILE = 'results.out'
+
+        if edpAppExe is not None:
+            edpAppDataList = ['"{}"'.format(edpAppExeRemote), '--filenameBIM', inputFILE, '--filenameEVENT', eventFILE,
+                              '--filenameEDP', edpFILE]
+            if (edpAppExe.endswith('.py')):
+                edpAppDataList.insert(0, 'python')
+
+            for key in edpAppData.keys():
+                edpAppDataList.append(u"--" + key)
+                edpAppDataList.append(u"" + str(edpAppData.get(key)))
+
+            for item in edpAppDataList:
+                driverFILE.write('%s ' % item)
+            driverFILE.write('\n')
+
+            edpAppDataList.append('--getRV')
+            if (edpAppExe.endswith('.py')):
+                edpAppDataList[1] = u""+edpAppExeLocal
+            else:
+                edpAppDataList[0] = u""+edpAppExeLocal
+
+            command, result, returncode = runApplication(edpAppDataList)
+            log_output.append([command, result, returncode])
+
+        if simAppExe is not None:
+            simAppDataList = ['"{}"'.format(simAppExeRemote), '--filenameBIM', inputFILE, '--filenameEVENT', eventFILE,
+                              '--filenameEDP', edpFILE, '--filenameResults', resultsFILE]
+            if (simAppExe.endswith('.py')):
+                simAppDataList.insert(0, 'python')
+
+            for key in simAppData.keys():
+                simAppDataList.append(u"--" + key)
+                simAppDataList.append(u"" + str(simAppData.get(key)))
+
+            for item in simAppDataList:
+                driverFILE.write('%s ' % item)
+            driverFILE.write('\n')
+
 
         # perform the simulation
         driverFILE.close()
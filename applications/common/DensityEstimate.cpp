@@ -0,0 +1,152 @@
+#include <DensityEstimate.h>
+#include <FFT.h>
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+
+//
+// the p quantile of the samples, interpolated between the closest ranks; the samples are
+// partly reordered
+//
+
+static double
+getQuantile(std::vector<double> &samples, double p)
+{
+    int n = samples.size();
+    double position = p*(n-1);
+    int lower = int(position);
+    std::nth_element(samples.begin(), samples.begin()+lower, samples.end());
+    double value = samples[lower];
+    if (lower+1 < n) {
+        double next = *std::min_element(samples.begin()+lower+1, samples.end());
+        value += (position-lower)*(next-value);
+    }
+    return value;
+}
+
+int
+computeDensityEstimate(const double *values, int numValues, DensityEstimate &theEstimate,
+                       int maxBins, int numGrid)
+{
+    std::vector<double> samples;
+    samples.reserve(numValues);
+    for (int i=0; i<numValues; i++)
+        if (std::isfinite(values[i]))
+            samples.push_back(values[i]);
+
+    int n = samples.size();
+    theEstimate.min = 0.0;
+    theEstimate.max = 0.0;
+    theEstimate.binWidth = 1.0;
+    theEstimate.bandwidth = 0.0;
+    theEstimate.gridStart = 0.0;
+    theEstimate.gridStep = 1.0;
+    theEstimate.fraction.clear();
+    theEstimate.density.clear();
+    if (n == 0)
+        return -1;
+
+    //
+    // moments and quartiles
+    //
+
+    double min = samples[0], max = samples[0], sum = 0.0;
+    for (int i=0; i<n; i++) {
+        min = std::min(min, samples[i]);
+        max = std::max(max, samples[i]);
+        sum += samples[i];
+    }
+    double mean = sum/n;
+    double sumSquares = 0.0;
+    for (int i=0; i<n; i++)
+        sumSquares += (samples[i]-mean)*(samples[i]-mean);
+    double sigma = (n > 1) ? sqrt(sumSquares/(n-1)) : 0.0;
+
+    double lowerQuartile = getQuantile(samples, 0.25);
+    double upperQuartile = getQuantile(samples, 0.75);
+    double iqr = upperQuartile - lowerQuartile;
+
+    //
+    // histogram
+    //
+
+    double cubeRoot = pow(double(n), -1.0/3.0);
+    double width = 0.0;
+    if (iqr > 0.0)
+        width = 2.0*iqr*cubeRoot;
+    else if (sigma > 0.0)
+        width = 3.49*sigma*cubeRoot;
+
+    int numBins = 1;
+    if (max > min && width > 0.0)
+        numBins = std::max(1, std::min(maxBins, int(ceil((max-min)/width))));
+
+    theEstimate.min = min;
+    theEstimate.max = max;
+    theEstimate.binWidth = (max > min) ? (max-min)/numBins : 1.0;
+    if (max == min)
+        theEstimate.min = min - 0.5;  // one bin around the single value
+
+    theEstimate.fraction.assign(numBins, 0.0);
+    for (int i=0; i<n; i++) {
+        int bin = int(floor((samples[i]-theEstimate.min)/theEstimate.binWidth));
+        bin = std::max(0, std::min(numBins-1, bin));
+        theEstimate.fraction[bin] += 1.0;
+    }
+    for (int i=0; i<numBins; i++)
+        theEstimate.fraction[i] /= n;
+
+    //
+    // kernel density: the samples are shared linearly between the two nearest grid points, the
+    // grid counts convolved with the kernel by FFT, zero padded to twice the grid so nothing wraps
+    //
+
+    double spread = (iqr > 0.0) ? std::min(sigma, iqr/1.34) : sigma;
+    double bandwidth = 0.9*spread*pow(double(n), -0.2);
+    if (bandwidth <= 0.0)
+        bandwidth = theEstimate.binWidth/2.0;
+    theEstimate.bandwidth = bandwidth;
+
+    if (numGrid < 2)
+        numGrid = 2;
+    double gridStart = min - 3.0*bandwidth;
+    double gridStep = (max - min + 6.0*bandwidth)/(numGrid-1);
+    theEstimate.gridStart = gridStart;
+    theEstimate.gridStep = gridStep;
+
+    int size = FFT::nextPowerOfTwo(2*numGrid);
+    std::vector<std::complex<double> > counts(size, 0.0);
+    for (int i=0; i<n; i++) {
+        double position = (samples[i]-gridStart)/gridStep;
+        int lower = std::max(0, std::min(numGrid-2, int(floor(position))));
+        double weight = position - lower;
+        counts[lower] += 1.0 - weight;
+        counts[lower+1] += weight;
+    }
+
+    std::vector<std::complex<double> > kernel(size, 0.0);
+    double scale = 1.0/(n*bandwidth*sqrt(2.0*PI));
+    for (int j=0; j<numGrid; j++) {
+        double u = j*gridStep/bandwidth;
+        double value = scale*exp(-0.5*u*u);
+        kernel[j] = value;
+        if (j != 0)
+            kernel[size-j] = value;
+    }
+
+    FFT theFFT(size);
+    theFFT.forward(counts.data());
+    theFFT.forward(kernel.data());
+    for (int k=0; k<size; k++)
+        counts[k] *= kernel[k];
+    theFFT.inverse(counts.data());
+
+    theEstimate.density.resize(numGrid);
+    for (int i=0; i<numGrid; i++)
+        theEstimate.density[i] = std::max(0.0, counts[i].real());
+
+    return n;
+}
@@ -0,0 +1,29 @@
+#ifndef DENSITY_ESTIMATE_H
+#define DENSITY_ESTIMATE_H
+
+#include <vector>
+
+//The DensityEstimate holds the histogram and the kernel density of a set of samples. The bin
+//width is from the Freedman-Diaconis rule (2 IQR n^-1/3), from Scott's rule (3.49 sigma n^-1/3)
+//when the interquartile range is 0; the density is a Gaussian kernel estimate with Silverman's
+//bandwidth, computed on a regular grid by binning the samples and convolving the bins with the
+//kernel by FFT, so its cost does not depend on the number of samples beyond the binning.
+struct DensityEstimate
+{
+    double min;                      // of the samples, the start of the first bin
+    double max;
+    double binWidth;
+    std::vector<double> fraction;    // fraction of the samples in each bin
+
+    double bandwidth;
+    double gridStart;                // the grid of the density, gridStart + i*gridStep
+    double gridStep;
+    std::vector<double> density;     // integrates to 1 over the grid
+};
+
+//This method computes the histogram (at most maxBins bins) and the kernel density (numGrid
+//points) of the finite values, returns the number of them used, -1 if there are none
+int computeDensityEstimate(const double *values, int numValues, DensityEstimate &theEstimate,
+                           int maxBins = 200, int numGrid = 2048);
+
+#endif
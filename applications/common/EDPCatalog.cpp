@@ -0,0 +1,164 @@
+#include <EDPCatalog.h>
+#include <IntensityMeasures.h>
+
+#include <string.h>
+#include <iostream>
+
+//
+// the definition table, in the order the responses are written
+//
+
+static const EDPCatalog::Definition definitions[EDPCatalog::NumMeasures] = {
+    {EDPCatalog::PGA,   "PGA"},
+    {EDPCatalog::SA,    "SA"},
+    {EDPCatalog::PGV,   "PGV"},
+    {EDPCatalog::PGD,   "PGD"},
+    {EDPCatalog::AI,    "AI"},
+    {EDPCatalog::D5_95, "D5_95"},
+};
+
+EDPCatalog::EDPCatalog()
+    :measuresGiven(false), damping(0.05)
+{
+    for (int i=0; i<NumMeasures; i++)
+        requested[i] = false;
+}
+
+const EDPCatalog::Definition &
+EDPCatalog::getDefinition(Measure measure)
+{
+    return definitions[measure];
+}
+
+EDPCatalog::Measure
+EDPCatalog::findMeasure(const char *type)
+{
+    for (int i=0; i<NumMeasures; i++)
+        if (strcmp(definitions[i].type, type) == 0)
+            return definitions[i].measure;
+    return NumMeasures;
+}
+
+int
+EDPCatalog::setMeasures(const char *list)
+{
+    for (int i=0; i<NumMeasures; i++)
+        requested[i] = false;
+    measuresGiven = true;
+
+    std::string names(list);
+    size_t start = 0;
+    while (start <= names.size()) {
+        size_t end = names.find(',', start);
+        if (end == std::string::npos)
+            end = names.size();
+        std::string name = names.substr(start, end-start);
+        if (name.size() != 0) {
+            Measure measure = findMeasure(name.c_str());
+            if (measure == NumMeasures) {
+                std::cerr << "EDPCatalog - unknown measure " << name << "\n";
+                return -1;
+            }
+            requested[measure] = true;
+        }
+        start = end+1;
+    }
+    return 0;
+}
+
+int
+EDPCatalog::readRequest(json_t *request)
+{
+    json_t *measures = json_object_get(request, "measures");
+    if (measures != NULL) {
+        std::string list;
+        for (size_t i=0; i<json_array_size(measures); i++) {
+            const char *name = json_string_value(json_array_get(measures, i));
+            if (name == NULL) {
+                std::cerr << "EDPCatalog - measures must be names\n";
+                return -1;
+            }
+            list += std::string(name) + ",";
+        }
+        if (this->setMeasures(list.c_str()) < 0)
+            return -1;
+    }
+
+    json_t *periodArray = json_object_get(request, "periods");
+    if (periodArray != NULL) {
+        periods.clear();
+        for (size_t i=0; i<json_array_size(periodArray); i++) {
+            double period = json_number_value(json_array_get(periodArray, i));
+            if (period <= 0.0) {
+                std::cerr << "EDPCatalog - periods must be positive\n";
+                return -1;
+            }
+            periods.push_back(period);
+        }
+    }
+
+    json_t *dampingValue = json_object_get(request, "damping");
+    if (dampingValue != NULL)
+        damping = json_number_value(dampingValue);
+
+    return 0;
+}
+
+int
+EDPCatalog::configure(const char *filenameBIM, const char *measureList, const char *periodList)
+{
+    if (filenameBIM != 0) {
+        json_error_t error;
+        json_t *rootBIM = json_load_file(filenameBIM, 0, &error);
+        if (rootBIM == NULL) {
+            std::cerr << "EDPCatalog - could not parse " << filenameBIM << ": " << error.text << "\n";
+            return -1;
+        }
+        json_t *request = json_object_get(rootBIM, "IntensityMeasures");
+        int result = (request != NULL) ? this->readRequest(request) : 0;
+        json_decref(rootBIM);
+        if (result < 0)
+            return -1;
+    }
+
+    if (measureList != 0 && this->setMeasures(measureList) < 0)
+        return -1;
+
+    if (periodList != 0 && parsePeriods(periodList, periods) <= 0) {
+        std::cerr << "EDPCatalog - invalid period list " << periodList << "\n";
+        return -1;
+    }
+
+    //
+    // defaults: PGA alone, or everything but PGD once periods are given
+    //
+
+    if (measuresGiven == false) {
+        requested[PGA] = true;
+        if (periods.size() != 0)
+            requested[SA] = requested[PGV] = requested[AI] = requested[D5_95] = true;
+    }
+
+    if (requested[SA] && periods.size() == 0)
+        periods = getDefaultPeriods();
+
+    entries.clear();
+    for (int i=0; i<NumMeasures; i++) {
+        if (requested[i] == false)
+            continue;
+        Entry theEntry;
+        theEntry.measure = definitions[i].measure;
+        theEntry.period = 0.0;
+        theEntry.type = definitions[i].type;
+        if (theEntry.measure == SA) {
+            for (unsigned int j=0; j<periods.size(); j++) {
+                theEntry.period = periods[j];
+                theEntry.type = getSpectralType(periods[j]);
+                entries.push_back(theEntry);
+            }
+        } else
+            entries.push_back(theEntry);
+    }
+
+    return entries.size();
+}
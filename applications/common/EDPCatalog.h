@@ -0,0 +1,65 @@
+#ifndef EDP_CATALOG_H
+#define EDP_CATALOG_H
+
+#include <vector>
+#include <string>
+#include <jansson.h>
+
+//The EDPCatalog class holds the definition table of the ground motion EDPs and the set of them
+//requested for a run. The EDP application writes its template from the catalog and the
+//simulation application fills it from the same catalog, so the two always agree on the
+//responses and their order. The request is read from "IntensityMeasures" in the BIM,
+//
+//   "IntensityMeasures": {"measures":["PGA","SA","PGV"], "periods":[0.2,0.5,1.0], "damping":0.05}
+//
+//and may be overridden from the command line with --measures PGA,SA,PGV and --periods 0.2,0.5,1.0.
+//With no request only PGA is written; with periods but no measures every measure but PGD is.
+
+class EDPCatalog
+{
+public:
+    enum Measure {PGA, SA, PGV, PGD, AI, D5_95, NumMeasures};
+
+    struct Definition
+    {
+        Measure measure;
+        const char *type;         // response type, SA entries are written as SA_<period>
+    };
+
+    struct Entry
+    {
+        Measure measure;
+        double period;            // SA only
+        std::string type;
+    };
+
+    EDPCatalog();
+
+    //This method sets up the request from the BIM file (may be null) and the command line
+    //lists (may be null), returns the number of entries for each dof or -1 on error
+    int configure(const char *filenameBIM, const char *measureList, const char *periodList);
+
+    bool hasMeasure(Measure measure) const {return requested[measure];}
+    const std::vector<double> &getPeriods(void) const {return periods;}
+    double getDamping(void) const {return damping;}
+
+    //This method returns the requested responses in the order they are written
+    const std::vector<Entry> &getEntries(void) const {return entries;}
+
+    static const Definition &getDefinition(Measure measure);
+
+    //This method returns the measure of a type name (e.g. "PGV"), NumMeasures if unknown
+    static Measure findMeasure(const char *type);
+
+private:
+    int setMeasures(const char *list);
+    int readRequest(json_t *request);
+
+    bool requested[NumMeasures];
+    bool measuresGiven;
+    std::vector<double> periods;
+    double damping;
+    std::vector<Entry> entries;
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include <EDPWriter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <iostream>
+
+#if defined(__has_include) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+#define EDP_HEADER "{\"RandomVariables\": [], \"EngineeringDemandParameters\": ["
+
+EDPWriter::EDPWriter()
+    :numEvents(0), numResponses(0), numEDP(0)
+{
+    this->clear();
+}
+
+void
+EDPWriter::clear(void)
+{
+    buffer.assign(EDP_HEADER);
+    results.clear();
+    numEvents = 0;
+    numResponses = 0;
+    numEDP = 0;
+}
+
+void
+EDPWriter::beginEvent(const char *name)
+{
+    if (numEvents++ != 0)
+        buffer += ", ";
+    buffer += "{\"name\": ";
+    this->appendString(name);
+    buffer += ", \"responses\": [";
+    numResponses = 0;
+}
+
+void
+EDPWriter::endEvent(void)
+{
+    buffer += "]}";
+}
+
+void
+EDPWriter::addResponse(const char *type, const int *dofs, const double *values, int numDofs,
+                       double period)
+{
+    char text[32];
+
+    if (numResponses++ != 0)
+        buffer += ", ";
+    buffer += "{\"type\": ";
+    this->appendString(type);
+
+    if (period > 0.0) {
+        buffer += ", \"period\": ";
+        buffer.append(text, formatDouble(text, period, true));
+    }
+
+    buffer += ", \"dofs\": [";
+    for (int i=0; i<numDofs; i++) {
+        if (i != 0)
+            buffer += ", ";
+        int length = snprintf(text, sizeof(text), "%d", dofs[i]);
+        buffer.append(text, length);
+    }
+
+    buffer += "], \"scalar_data\": [";
+    if (values != 0) {
+        for (int i=0; i<numDofs; i++) {
+            if (i != 0)
+                buffer += ", ";
+            buffer.append(text, formatDouble(text, values[i], true));
+
+            if (results.size() != 0)
+                results += ' ';
+            results.append(text, formatDouble(text, values[i], false));
+        }
+    }
+    buffer += "]}";
+
+    numEDP += numDofs;
+}
+
+//
+// both files are written unbuffered, the whole text in one write
+//
+
+static int
+writeText(const char *filename, const char *text, size_t length)
+{
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        std::cerr << "ERROR - could not create " << filename << "\n";
+        return -1;
+    }
+    setvbuf(fp, NULL, _IONBF, 0);
+
+    bool ok = (fwrite(text, 1, length, fp) == length);
+    ok = (fclose(fp) == 0) && ok;
+    if (ok == false) {
+        std::cerr << "ERROR - could not write " << filename << "\n";
+        return -1;
+    }
+    return 0;
+}
+
+int
+EDPWriter::writeEDP(const char *filenameEDP)
+{
+    // the closing is added for the write only, so more events may still follow
+    size_t length = buffer.size();
+    char footer[64];
+    snprintf(footer, sizeof(footer), "], \"total_number_edp\": %d}", numEDP);
+    buffer += footer;
+
+    int result = writeText(filenameEDP, buffer.data(), buffer.size());
+    buffer.resize(length);
+    return result;
+}
+
+int
+EDPWriter::writeResults(const char *filenameResults)
+{
+    results += '\n';
+    int result = writeText(filenameResults, results.data(), results.size());
+    results.resize(results.size()-1);
+    return result;
+}
+
+char *
+EDPWriter::formatDouble(char *pos, double value, bool json)
+{
+    if (std::isfinite(value) == false) {
+        const char *text = json ? "null" : (std::isnan(value) ? "nan" : (value > 0 ? "inf" : "-inf"));
+        size_t length = strlen(text);
+        memcpy(pos, text, length);
+        return pos + length;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    char *end = std::to_chars(pos, pos+32, value).ptr;
+#else
+    // 15 digits are enough for most values, 17 always are
+    int length = snprintf(pos, 32, "%.15g", value);
+    if (strtod(pos, 0) != value)
+        length = snprintf(pos, 32, "%.17g", value);
+    char *end = pos + length;
+#endif
+
+    // keep the value a json real (the text is not terminated)
+    if (json) {
+        char *check = pos;
+        while (check != end && *check != '.' && *check != 'e' && *check != 'E')
+            check++;
+        if (check == end) {
+            memcpy(end, ".0", 2);
+            end += 2;
+        }
+    }
+
+    return end;
+}
+
+void
+EDPWriter::appendString(const char *value)
+{
+    buffer += '"';
+    for (const char *pos = value; *pos != '\0'; pos++) {
+        unsigned char c = *pos;
+        if (c == '"' || c == '\\') {
+            buffer += '\\';
+            buffer += c;
+        } else if (c < 0x20) {
+            char escape[8];
+            snprintf(escape, sizeof(escape), "\\u%04x", c);
+            buffer += escape;
+        } else
+            buffer += c;
+    }
+    buffer += '"';
+}
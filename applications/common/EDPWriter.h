@@ -0,0 +1,54 @@
+#ifndef EDP_WRITER_H
+#define EDP_WRITER_H
+
+#include <string>
+
+//The EDPWriter class serializes the EDP file of a simulation application, and the results.out
+//of the dakota fork interface, straight from the values: the text is appended to one buffer,
+//numbers in their shortest round trip form, and written with a single write. No json values
+//are made, so the cost does not grow with the number of responses beyond the text itself.
+//
+//   {"RandomVariables": [], "EngineeringDemandParameters": [{"name": ..., "responses": [
+//      {"type": "PGA", "dofs": [1, 2], "scalar_data": [0.31, 0.27]}, ...]}, ...],
+//    "total_number_edp": n}
+//
+//The results.out holds the scalar data of all the responses, in the order they were added,
+//on one line separated by spaces.
+
+class EDPWriter
+{
+public:
+    EDPWriter();
+
+    //This method starts a new EDP file, the buffer memory is kept for reuse
+    void clear(void);
+
+    void beginEvent(const char *name);
+    void endEvent(void);
+
+    //This method adds a response of the current event, one value for each dof; with no values
+    //the scalar data is left empty (the EDP template); a period > 0 is written as "period"
+    void addResponse(const char *type, const int *dofs, const double *values, int numDofs,
+                     double period = 0.0);
+
+    int getNumEDP(void) const {return numEDP;}
+
+    //These methods write the files, returning 0 if ok, -1 (with a message) if not
+    int writeEDP(const char *filenameEDP);
+    int writeResults(const char *filenameResults);
+
+    //This method appends the shortest text that reads back as the same double (json null for
+    //nan and inf, a ".0" added to integral values when json is true), returns the end of it
+    static char *formatDouble(char *pos, double value, bool json);
+
+private:
+    void appendString(const char *value);
+
+    std::string buffer;        // the EDP json after the opening
+    std::string results;       // the values of results.out
+    int numEvents;
+    int numResponses;          // of the current event
+    int numEDP;
+};
+
+#endif
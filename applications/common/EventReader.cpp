@@ -0,0 +1,662 @@
+#include <EventReader.h>
+#include <SeriesReduction.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <memory>
+
+#define READ_BUFFER_SIZE 65536
+#define PEAK_BLOCK_SIZE 256
+#define MAX_SIGNIFICANT_DIGITS 40
+
+//
+// JsonInput: pull parser over a file read through a fixed size buffer
+//
+
+class JsonInput
+{
+public:
+    JsonInput(FILE *theFile, char *theBuffer)
+        :fp(theFile), buffer(theBuffer), pos(0), end(0), offset(0), fileSize(0), error(false) {
+        if (fseek(fp, 0, SEEK_END) == 0) {
+            long size = ftell(fp);
+            fileSize = (size > 0) ? size : 0;
+        }
+        fseek(fp, 0, SEEK_SET);
+    }
+
+    // the most numbers the rest of the file can hold, each a digit and a comma
+    size_t getMaxNumbers(void) const {
+        size_t read = offset + pos;
+        return (fileSize > read) ? (fileSize - read)/2 + 1 : 0;
+    }
+
+    // next non white space character (not consumed), EOF at end of file
+    int peek(void) {
+        for (;;) {
+            if (pos == end && fill() == false)
+                return EOF;
+            char c = buffer[pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                return (unsigned char)c;
+            pos++;
+        }
+    }
+
+    bool expect(char c) {
+        if (peek() != (unsigned char)c)
+            return fail("expected '" + std::string(1, c) + "'");
+        pos++;
+        return true;
+    }
+
+    // consumes c if it is the next character
+    bool accept(char c) {
+        if (peek() != (unsigned char)c)
+            return false;
+        pos++;
+        return true;
+    }
+
+    bool readString(std::string &value) {
+        value.clear();
+        if (expect('"') == false)
+            return false;
+        for (;;) {
+            int c = get();
+            if (c == EOF)
+                return fail("unterminated string");
+            if (c == '"')
+                return true;
+            if (c != '\\') {
+                value += (char)c;
+                continue;
+            }
+            c = get();
+            switch (c) {
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'n': value += '\n'; break;
+            case 'r': value += '\r'; break;
+            case 't': value += '\t'; break;
+            case 'u': {
+                unsigned int code = 0;
+                for (int i=0; i<4; i++) {
+                    int h = get();
+                    code <<= 4;
+                    if (h >= '0' && h <= '9') code += h - '0';
+                    else if (h >= 'a' && h <= 'f') code += h - 'a' + 10;
+                    else if (h >= 'A' && h <= 'F') code += h - 'A' + 10;
+                    else return fail("bad unicode escape");
+                }
+                // basic multilingual plane only, as utf-8
+                if (code < 0x80) {
+                    value += (char)code;
+                } else if (code < 0x800) {
+                    value += (char)(0xC0 | (code >> 6));
+                    value += (char)(0x80 | (code & 0x3F));
+                } else {
+                    value += (char)(0xE0 | (code >> 12));
+                    value += (char)(0x80 | ((code >> 6) & 0x3F));
+                    value += (char)(0x80 | (code & 0x3F));
+                }
+                break;
+            }
+            case EOF:
+                return fail("unterminated string");
+            default:
+                value += (char)c;
+            }
+        }
+    }
+
+    bool readNumber(double &value) {
+        char token[64];
+        int length = readToken(token);
+        if (length <= 0)
+            return false;
+        char *last;
+        value = strtod(token, &last);
+        if (last != token + length)
+            return fail("bad number");
+        return true;
+    }
+
+    // consumes a number without converting it
+    bool skipNumber(void) {
+        char token[64];
+        return readToken(token) > 0;
+    }
+
+    // true, false or null
+    bool readLiteral(void) {
+        int c = peek();
+        const char *word = (c == 't') ? "true" : (c == 'f') ? "false" : (c == 'n') ? "null" : 0;
+        if (word == 0)
+            return fail("unexpected character");
+        for (const char *w = word; *w != '\0'; w++)
+            if (get() != *w)
+                return fail("bad literal");
+        return true;
+    }
+
+    bool skipValue(void) {
+        int c = peek();
+        if (c == '"') {
+            std::string ignored;
+            return readString(ignored);
+        } else if (c == '{') {
+            pos++;
+            if (accept('}'))
+                return true;
+            do {
+                std::string key;
+                if (readString(key) == false || expect(':') == false || skipValue() == false)
+                    return false;
+            } while (accept(','));
+            return expect('}');
+        } else if (c == '[') {
+            pos++;
+            if (accept(']'))
+                return true;
+            do {
+                if (skipValue() == false)
+                    return false;
+            } while (accept(','));
+            return expect(']');
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            return skipNumber();
+        }
+        return readLiteral();
+    }
+
+    bool fail(const std::string &message) {
+        if (error == false)
+            std::cerr << "EventReader - " << message << " at byte " << offset + pos << "\n";
+        error = true;
+        return false;
+    }
+
+    bool hasError(void) const {return error;}
+
+private:
+    //
+    // reads a number into token as its significant digits and a decimal exponent, [-]DDDeX, for
+    // strtod: the digits past the first MAX_SIGNIFICANT_DIGITS, more than a double holds, are
+    // dropped, those of the integer part moving the exponent, so a number of any length is read
+    //
+    int readToken(char *token) {
+        int length = 0;
+        peek();
+        int c = look();
+        if (c == '-' || c == '+') {
+            if (c == '-')
+                token[length++] = '-';
+            pos++;
+            c = look();
+        }
+
+        int start = length;
+        int numDigits = 0;
+        long exponent = 0;
+        bool point = false;
+        for (;; c = look()) {
+            if (c >= '0' && c <= '9') {
+                numDigits++;
+                if (length == start && c == '0') {
+                    if (point)
+                        exponent--;
+                } else if (length - start < MAX_SIGNIFICANT_DIGITS) {
+                    token[length++] = (char)c;
+                    if (point)
+                        exponent--;
+                } else if (!point) {
+                    exponent++;
+                }
+            } else if (c == '.' && !point) {
+                point = true;
+            } else {
+                break;
+            }
+            pos++;
+        }
+        if (numDigits == 0) {
+            fail("expected a number");
+            return -1;
+        }
+        if (length == start)
+            token[length++] = '0';
+
+        if (c == 'e' || c == 'E') {
+            pos++;
+            c = look();
+            bool negative = (c == '-');
+            if (c == '-' || c == '+') {
+                pos++;
+                c = look();
+            }
+            if (c < '0' || c > '9') {
+                fail("bad number");
+                return -1;
+            }
+            // past this strtod gives 0 or inf whatever the digits
+            long value = 0;
+            for (; c >= '0' && c <= '9'; c = look()) {
+                if (value < 100000)
+                    value = 10*value + (c - '0');
+                pos++;
+            }
+            exponent += negative ? -value : value;
+        }
+
+        // a number run on into more of one, 1.2.3 or 1-2, is not one
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+            fail("bad number");
+            return -1;
+        }
+
+        length += sprintf(token + length, "e%ld", exponent);
+        return length;
+    }
+
+    // next character (not consumed), EOF at end of file
+    int look(void) {
+        if (pos == end && fill() == false)
+            return EOF;
+        return (unsigned char)buffer[pos];
+    }
+
+    int get(void) {
+        if (pos == end && fill() == false)
+            return EOF;
+        return (unsigned char)buffer[pos++];
+    }
+
+    bool fill(void) {
+        offset += end;
+        pos = 0;
+        end = fread(buffer, 1, READ_BUFFER_SIZE, fp);
+        return end != 0;
+    }
+
+    FILE *fp;
+    char *buffer;
+    size_t pos;
+    size_t end;
+    size_t offset;
+    size_t fileSize;
+    bool error;
+};
+
+//
+// typed members: a value of another type is skipped and the member left unchanged
+//
+
+static bool
+readStringMember(JsonInput &in, std::string &value)
+{
+    if (in.peek() == '"')
+        return in.readString(value);
+    return in.skipValue();
+}
+
+static bool
+readNumberMember(JsonInput &in, double &value)
+{
+    int c = in.peek();
+    if (c == '-' || (c >= '0' && c <= '9'))
+        return in.readNumber(value);
+    return in.skipValue();
+}
+
+static bool
+readData(JsonInput &in, EventTimeSeries &theSeries, EventReader::DataMode mode, int expectedSteps)
+{
+    if (in.peek() != '[')
+        return in.skipValue();
+    in.expect('[');
+
+    theSeries.data.clear();
+    theSeries.numSteps = 0;
+    theSeries.peak = 0.0;
+    if (in.accept(']'))
+        return true;
+
+    // sized from the event numSteps when it came first, no more than the rest of the file can hold
+    if (mode == EventReader::ReadData && expectedSteps > 0)
+        theSeries.data.reserve(std::min((size_t)expectedSteps, in.getMaxNumbers()));
+
+    // when only the peak is wanted the values are reduced a block at a time
+    double block[PEAK_BLOCK_SIZE];
+    int numBlock = 0;
+    double peak = 0.0;
+    int numSteps = 0;
+    do {
+        if (mode == EventReader::SkipData) {
+            if (in.skipNumber() == false)
+                return false;
+            numSteps++;
+            continue;
+        }
+        double value;
+        if (in.readNumber(value) == false)
+            return false;
+        if (mode == EventReader::ReadData)
+            theSeries.data.push_back(value);
+        else {
+            block[numBlock++] = value;
+            if (numBlock == PEAK_BLOCK_SIZE) {
+                peak = std::max(peak, getPeakAbsolute(block, numBlock));
+                numBlock = 0;
+            }
+        }
+        numSteps++;
+    } while (in.accept(','));
+
+    if (mode == EventReader::ReadData) {
+        // the samples take no more than their size when numSteps was not known or was wrong
+        if (theSeries.data.capacity() > theSeries.data.size())
+            theSeries.data.shrink_to_fit();
+        peak = getPeakAbsolute(theSeries.data.data(), theSeries.data.size());
+    }
+    else if (mode == EventReader::PeakOnly)
+        peak = std::max(peak, getPeakAbsolute(block, numBlock));
+
+    theSeries.peak = peak;
+    theSeries.numSteps = numSteps;
+    return in.expect(']');
+}
+
+static bool
+readTimeSeries(JsonInput &in, EventTimeSeries &theSeries, EventReader::DataMode mode,
+               const char *filename, int expectedSteps)
+{
+    if (in.expect('{') == false)
+        return false;
+    if (in.accept('}'))
+        return true;
+
+    std::string key;
+    do {
+        if (in.readString(key) == false || in.expect(':') == false)
+            return false;
+        bool ok;
+        if (key == "name")
+            ok = readStringMember(in, theSeries.name);
+        else if (key == "type")
+            ok = readStringMember(in, theSeries.type);
+        else if (key == "dT")
+            ok = readNumberMember(in, theSeries.dT);
+        else if (key == "factor")
+            ok = readNumberMember(in, theSeries.factor);
+        else if (key == "data")
+            ok = readData(in, theSeries, mode, expectedSteps);
+        else if (key == "dataFile") {
+            ok = readStringMember(in, theSeries.dataFile);
+            if (ok == true && theSeries.dataFile.size() != 0)
+                theSeries.dataFile = TimeSeriesFile::resolvePath(theSeries.dataFile.c_str(), filename);
+        } else
+            ok = in.skipValue();
+        if (ok == false)
+            return false;
+    } while (in.accept(','));
+
+    return in.expect('}');
+}
+
+//
+// binary sidecar: mapped and kept when reading data, otherwise reduced (or only sized) and released
+//
+
+static bool
+readDataFile(EventTimeSeries &theSeries, const EventRecord &theEvent, EventReader::DataMode mode)
+{
+    std::shared_ptr<TimeSeriesFile> theFile(new TimeSeriesFile());
+    if (theFile->open(theSeries.dataFile.c_str()) < 0)
+        return false;
+    if (theFile->hasUnits(theEvent.lengthUnit.c_str(), theEvent.timeUnit.c_str()) == false) {
+        std::cerr << "EventReader - units " << theFile->getUnits() << " of " << theSeries.dataFile
+                  << " differ from those of the event\n";
+        return false;
+    }
+
+    int numSteps = theFile->getNumSteps();
+    theSeries.numSteps = numSteps;
+    if (theSeries.dT <= 0.0)
+        theSeries.dT = theFile->getTimeStep();
+
+    if (mode != EventReader::SkipData)
+        theSeries.peak = getPeakAbsolute(theFile->getData(), numSteps);
+
+    if (mode == EventReader::ReadData) {
+        theSeries.data.clear();
+        theSeries.file = theFile;
+    }
+
+    return true;
+}
+
+static bool
+readPattern(JsonInput &in, EventPattern &thePattern)
+{
+    if (in.expect('{') == false)
+        return false;
+    if (in.accept('}'))
+        return true;
+
+    std::string key;
+    do {
+        if (in.readString(key) == false || in.expect(':') == false)
+            return false;
+        bool ok;
+        if (key == "type")
+            ok = readStringMember(in, thePattern.type);
+        else if (key == "timeSeries")
+            ok = readStringMember(in, thePattern.timeSeries);
+        else if (key == "dof") {
+            double dof = 0.0;
+            ok = readNumberMember(in, dof);
+            thePattern.dof = (int)dof;
+        } else
+            ok = in.skipValue();
+        if (ok == false)
+            return false;
+    } while (in.accept(','));
+
+    return in.expect('}');
+}
+
+static bool
+readUnits(JsonInput &in, EventRecord &theEvent)
+{
+    if (in.peek() != '{')
+        return in.skipValue();
+    in.expect('{');
+    if (in.accept('}'))
+        return true;
+
+    std::string key;
+    do {
+        if (in.readString(key) == false || in.expect(':') == false)
+            return false;
+        bool ok;
+        if (key == "length")
+            ok = readStringMember(in, theEvent.lengthUnit);
+        else if (key == "time")
+            ok = readStringMember(in, theEvent.timeUnit);
+        else
+            ok = in.skipValue();
+        if (ok == false)
+            return false;
+    } while (in.accept(','));
+
+    return in.expect('}');
+}
+
+static bool
+readEvent(JsonInput &in, EventRecord &theEvent, EventReader::DataMode mode, const char *filename)
+{
+    if (in.expect('{') == false)
+        return false;
+
+    if (in.accept('}') == false) {
+        std::string key;
+        do {
+            if (in.readString(key) == false || in.expect(':') == false)
+                return false;
+            bool ok = true;
+            if (key == "name")
+                ok = readStringMember(in, theEvent.name);
+            else if (key == "type")
+                ok = readStringMember(in, theEvent.type);
+            else if (key == "dT")
+                ok = readNumberMember(in, theEvent.dT);
+            else if (key == "numSteps") {
+                double numSteps = 0.0;
+                ok = readNumberMember(in, numSteps);
+                theEvent.numSteps = (int)numSteps;
+            }
+            else if (key == "units")
+                ok = readUnits(in, theEvent);
+            else if (key == "timeSeries" && in.peek() == '[') {
+                in.expect('[');
+                if (in.accept(']') == false) {
+                    do {
+                        theEvent.timeSeries.push_back(EventTimeSeries());
+                        if (readTimeSeries(in, theEvent.timeSeries.back(), mode, filename,
+                                           theEvent.numSteps) == false)
+                            return false;
+                    } while (in.accept(','));
+                    ok = in.expect(']');
+                }
+            }
+            else if (key == "pattern" && in.peek() == '[') {
+                in.expect('[');
+                if (in.accept(']') == false) {
+                    do {
+                        theEvent.pattern.push_back(EventPattern());
+                        if (readPattern(in, theEvent.pattern.back()) == false)
+                            return false;
+                    } while (in.accept(','));
+                    ok = in.expect(']');
+                }
+            }
+            else
+                ok = in.skipValue();
+            if (ok == false)
+                return false;
+        } while (in.accept(','));
+
+        if (in.expect('}') == false)
+            return false;
+    }
+
+    // sidecar data, then series dT defaults to the event dT
+    for (unsigned int i=0; i<theEvent.timeSeries.size(); i++) {
+        EventTimeSeries &theSeries = theEvent.timeSeries[i];
+        if (theSeries.dataFile.size() != 0 && readDataFile(theSeries, theEvent, mode) == false)
+            return false;
+        if (theSeries.dT <= 0.0)
+            theSeries.dT = theEvent.dT;
+    }
+
+    theEvent.buildIndex();
+    return true;
+}
+
+int
+EventRecord::findSeries(const std::string &seriesName) const
+{
+    std::unordered_map<std::string, int>::const_iterator found = seriesIndex.find(seriesName);
+    if (found == seriesIndex.end())
+        return -1;
+    return found->second;
+}
+
+void
+EventRecord::buildIndex(void)
+{
+    seriesIndex.clear();
+    seriesIndex.reserve(timeSeries.size());
+    for (unsigned int i=0; i<timeSeries.size(); i++)
+        seriesIndex.emplace(timeSeries[i].name, i);
+}
+
+EventReader::EventReader(DataMode theMode)
+    :mode(theMode), buffer(new char[READ_BUFFER_SIZE])
+{
+
+}
+
+EventReader::~EventReader()
+{
+    delete [] buffer;
+}
+
+int
+EventReader::read(const char *filename, std::vector<EventRecord> &events)
+{
+    events.clear();
+
+    int numEvents = this->read(filename, [&events](EventRecord &theEvent) {
+        events.push_back(std::move(theEvent));
+        return true;
+    });
+
+    if (numEvents < 0)
+        events.clear();
+    return numEvents;
+}
+
+int
+EventReader::read(const char *filename, const EventHandler &handler)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        std::cerr << "EventReader - could not open " << filename << "\n";
+        return -1;
+    }
+
+    // closed however the reading ends, the handler may throw
+    std::unique_ptr<FILE, int (*)(FILE *)> file(fp, fclose);
+    JsonInput in(fp, buffer);
+    bool ok = in.expect('{');
+    int numEvents = 0;
+
+    if (ok == true && in.accept('}') == false) {
+        std::string key;
+        do {
+            ok = in.readString(key) && in.expect(':');
+            if (ok == false)
+                break;
+            if (key == "Events" && in.peek() == '[') {
+                in.expect('[');
+                if (in.accept(']') == false) {
+                    do {
+                        // each event is handed over as soon as it is read and then released
+                        EventRecord theEvent;
+                        ok = readEvent(in, theEvent, mode, filename);
+                        if (ok == true && handler(theEvent) == false)
+                            return -1;
+                        numEvents++;
+                    } while (ok == true && in.accept(','));
+                    ok = ok && in.expect(']');
+                }
+            } else {
+                ok = in.skipValue();
+            }
+        } while (ok == true && in.accept(','));
+        ok = ok && in.expect('}');
+    }
+
+    if (ok == false) {
+        std::cerr << "EventReader - could not parse " << filename << "\n";
+        return -1;
+    }
+
+    return numEvents;
+}
@@ -0,0 +1,86 @@
+#ifndef EVENT_READER_H
+#define EVENT_READER_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <functional>
+#include <TimeSeriesFile.h>
+
+//The EventReader class reads the "Events" of an EVENT file without building a json tree.
+//The file is parsed in a single streaming pass over a small fixed buffer; the samples of each
+//timeSeries "data" array go straight into a contiguous vector, or are reduced to their peak
+//absolute value as they are parsed, or are only counted. Keys other than the ones below are skipped.
+//A series given by a binary "dataFile" (see TimeSeriesFile) is mapped rather than parsed.
+
+struct EventTimeSeries
+{
+    std::string name;
+    std::string type;
+    double dT = 0.0;
+    double factor = 1.0;
+    int numSteps = 0;
+    double peak = 0.0;            // max |data|, unscaled (not found when data is skipped)
+    std::vector<double> data;     // only filled when reading data
+    std::string dataFile;         // binary sidecar, resolved path
+    std::shared_ptr<TimeSeriesFile> file;  // mapped sidecar when reading data
+
+    //This method returns the samples, from data or the mapped sidecar
+    const double *getData(void) const {return file ? file->getData() : data.data();}
+};
+
+struct EventPattern
+{
+    std::string type;
+    std::string timeSeries;
+    int dof = 0;
+};
+
+struct EventRecord
+{
+    std::string name;
+    std::string type;
+    double dT = 0.0;
+    int numSteps = 0;
+    std::string lengthUnit;       // "units" of the event, empty if not given
+    std::string timeUnit;
+    std::vector<EventTimeSeries> timeSeries;
+    std::vector<EventPattern> pattern;
+
+    //This method returns the index of the named time series or -1
+    int findSeries(const std::string &seriesName) const;
+
+    void buildIndex(void);
+
+private:
+    std::unordered_map<std::string, int> seriesIndex;
+};
+
+class EventReader
+{
+public:
+    enum DataMode {ReadData, PeakOnly, SkipData};
+
+    EventReader(DataMode mode = ReadData);
+    ~EventReader();
+
+    //This method reads all the events of the file, returns the number of events or -1 on error.
+    //The read buffer is kept between calls, so one reader can go through any number of files
+    int read(const char *filename, std::vector<EventRecord> &events);
+
+    //This method passes each event to the handler as soon as it is read, the event is released
+    //before the next one is read so memory does not grow with the number of events. Reading
+    //stops with an error if the handler returns false
+    typedef std::function<bool(EventRecord &theEvent)> EventHandler;
+    int read(const char *filename, const EventHandler &handler);
+
+private:
+    EventReader(const EventReader &);
+    EventReader &operator=(const EventReader &);
+
+    DataMode mode;
+    char *buffer;
+};
+
+#endif
@@ -0,0 +1,252 @@
+#include <EventSeries.h>
+#include <TimeSeriesFile.h>
+#include <Units.h>
+#include <iostream>
+#include <string.h>
+#include <cmath>
+#include <unordered_map>
+
+int
+readEventSeries(json_t *event, std::vector<EventSeries> &series, const char *filename)
+{
+    series.clear();
+
+    json_t *patternArray = json_object_get(event,"pattern");
+    json_t *timeSeriesArray = json_object_get(event,"timeSeries");
+    int numPattern = json_array_size(patternArray);
+    int numSeries = json_array_size(timeSeriesArray);
+
+    // event level dT is used when a series has none of its own
+    double eventDT = 0.0;
+    json_t *eventDTObj = json_object_get(event,"dT");
+    if (eventDTObj != NULL)
+        eventDT = json_number_value(eventDTObj);
+
+    // the motion is in g unless the event gives its units
+    json_t *eventUnits = json_object_get(event,"units");
+    const char *lengthUnit = json_string_value(json_object_get(eventUnits,"length"));
+    const char *timeUnit = json_string_value(json_object_get(eventUnits,"time"));
+
+    // index the time series by name once, each series is read once however many patterns use it
+    std::unordered_map<std::string, int> seriesIndex;
+    seriesIndex.reserve(numSeries);
+    for (int i=0; i<numSeries; i++) {
+        const char *name = json_string_value(json_object_get(json_array_get(timeSeriesArray, i), "name"));
+        if (name != NULL)
+            seriesIndex.emplace(name, i);
+    }
+    std::vector<bool> done(numSeries, false);
+
+    for (int ii=0; ii<numPattern; ii++) {
+        json_t *thePattern = json_array_get(patternArray, ii);
+        const char *timeSeriesName = json_string_value(json_object_get(thePattern, "timeSeries"));
+        if (timeSeriesName == NULL)
+            continue;
+
+        std::unordered_map<std::string, int>::const_iterator found = seriesIndex.find(timeSeriesName);
+        if (found == seriesIndex.end() || done[found->second] == true)
+            continue;
+        done[found->second] = true;
+
+        json_t *theSeries = json_array_get(timeSeriesArray, found->second);
+        const char *subType = json_string_value(json_object_get(theSeries,"type"));
+        if (subType == NULL || strcmp(subType,"Value") != 0)
+            continue;
+
+        EventSeries theRecord;
+        theRecord.name = timeSeriesName;
+        theRecord.dT = eventDT;
+        theRecord.dof = json_integer_value(json_object_get(thePattern,"dof"));
+
+        json_t *dtObj = json_object_get(theSeries,"dT");
+        if (dtObj != NULL)
+            theRecord.dT = json_number_value(dtObj);
+
+        json_t *factorObj = json_object_get(theSeries,"factor");
+        if (factorObj != NULL && json_is_number(factorObj))
+            theRecord.factor = json_number_value(factorObj);
+
+        const char *dataFile = json_string_value(json_object_get(theSeries,"dataFile"));
+        if (dataFile != NULL) {
+            TimeSeriesFile theFile;
+            std::string path = TimeSeriesFile::resolvePath(dataFile, filename);
+            if (theFile.open(path.c_str()) < 0)
+                return -1;
+            if (theFile.hasUnits(lengthUnit, timeUnit) == false) {
+                std::cerr << "readEventSeries - units " << theFile.getUnits() << " of " << path
+                          << " differ from those of the event\n";
+                return -1;
+            }
+            theRecord.data.assign(theFile.getData(), theFile.getData() + theFile.getNumSteps());
+            if (dtObj == NULL)
+                theRecord.dT = theFile.getTimeStep();
+        } else {
+            json_t *data = json_object_get(theSeries,"data");
+            int numSteps = json_array_size(data);
+            theRecord.data.resize(numSteps);
+            for (int n=0; n<numSteps; n++)
+                theRecord.data[n] = json_number_value(json_array_get(data, n));
+        }
+
+        if (theRecord.dT <= 0.0) {
+            std::cerr << "readEventSeries - no dT for timeSeries " << timeSeriesName << "\n";
+            return -1;
+        }
+
+        series.push_back(theRecord);
+    }
+
+    return series.size();
+}
+
+int
+writeEventSeries(json_t *event, const EventSeries &series)
+{
+    json_t *timeSeriesArray = json_object_get(event,"timeSeries");
+    int numSeries = json_array_size(timeSeriesArray);
+
+    for (int i=0; i<numSeries; i++) {
+        json_t *theSeries = json_array_get(timeSeriesArray, i);
+        const char *name = json_string_value(json_object_get(theSeries, "name"));
+        if (name == NULL || series.name != name)
+            continue;
+
+        json_t *data = json_array();
+        for (unsigned int n=0; n<series.data.size(); n++)
+            json_array_append_new(data, json_real(series.data[n]));
+        json_object_set_new(theSeries,"data",data);
+        json_object_set_new(theSeries,"dT",json_real(series.dT));
+        json_object_del(theSeries,"dataFile");
+
+        return 0;
+    }
+
+    std::cerr << "writeEventSeries - no timeSeries named " << series.name << "\n";
+    return -1;
+}
+
+json_t *
+createSeismicEvent(const char *name, const std::vector<EventSeries> &series, const std::vector<int> &dofs)
+{
+    json_t *event = json_object();
+    json_object_set_new(event,"name",json_string(name));
+    json_object_set_new(event,"type",json_string("Seismic"));
+
+    json_t *timeSeriesArray = json_array();
+    json_t *patternArray = json_array();
+
+    int numSteps = 0;
+    double dT = 0.0;
+    for (unsigned int i=0; i<series.size(); i++) {
+        const EventSeries &theRecord = series[i];
+
+        json_t *theSeries = json_object();
+        json_object_set_new(theSeries,"name",json_string(theRecord.name.c_str()));
+        json_object_set_new(theSeries,"type",json_string("Value"));
+        json_object_set_new(theSeries,"dT",json_real(theRecord.dT));
+        json_object_set_new(theSeries,"factor",json_real(theRecord.factor));
+        json_t *data = json_array();
+        for (unsigned int n=0; n<theRecord.data.size(); n++)
+            json_array_append_new(data, json_real(theRecord.data[n]));
+        json_object_set_new(theSeries,"data",data);
+        json_array_append_new(timeSeriesArray, theSeries);
+
+        json_t *thePattern = json_object();
+        json_object_set_new(thePattern,"type",json_string("UniformAcceleration"));
+        json_object_set_new(thePattern,"timeSeries",json_string(theRecord.name.c_str()));
+        json_object_set_new(thePattern,"dof",json_integer(i < dofs.size() ? dofs[i] : i+1));
+        json_array_append_new(patternArray, thePattern);
+
+        if ((int)theRecord.data.size() > numSteps)
+            numSteps = theRecord.data.size();
+        dT = theRecord.dT;
+    }
+
+    json_object_set_new(event,"dT",json_real(dT));
+    json_object_set_new(event,"numSteps",json_integer(numSteps));
+    json_object_set_new(event,"timeSeries",timeSeriesArray);
+    json_object_set_new(event,"pattern",patternArray);
+
+    return event;
+}
+
+int
+readTargetSpectrum(const char *filename,
+                   std::vector<double> &periods,
+                   std::vector<double> &spectrum,
+                   double &dampingRatio,
+                   std::string &units)
+{
+    json_error_t error;
+    json_t *root = json_load_file(filename, 0, &error);
+    if (root == NULL) {
+        std::cerr << "readTargetSpectrum - could not parse " << filename << ": " << error.text << "\n";
+        return -1;
+    }
+
+    json_t *periodsArray = json_object_get(root,"periods");
+    json_t *spectrumArray = json_object_get(root,"spectrum");
+    int numPeriods = json_array_size(periodsArray);
+    if (numPeriods == 0 || (int)json_array_size(spectrumArray) != numPeriods) {
+        std::cerr << "readTargetSpectrum - periods and spectrum missing or of differing size\n";
+        json_decref(root);
+        return -1;
+    }
+
+    periods.resize(numPeriods);
+    spectrum.resize(numPeriods);
+    for (int i=0; i<numPeriods; i++) {
+        periods[i] = json_number_value(json_array_get(periodsArray, i));
+        spectrum[i] = json_number_value(json_array_get(spectrumArray, i));
+        if (!(periods[i] > 0.0) || !(spectrum[i] > 0.0) || std::isinf(periods[i]) || std::isinf(spectrum[i])) {
+            std::cerr << "readTargetSpectrum - periods and spectrum must be positive numbers, "
+                      << "entry " << i+1 << " of " << filename << " is not\n";
+            json_decref(root);
+            return -1;
+        }
+    }
+
+    dampingRatio = 0.05;
+    json_t *dampingObj = json_object_get(root,"damping");
+    if (dampingObj != NULL)
+        dampingRatio = json_number_value(dampingObj);
+
+    const char *unitsString = json_string_value(json_object_get(root,"units"));
+    units = (unitsString != NULL) ? unitsString : "";
+
+    json_decref(root);
+    return numPeriods;
+}
+
+double
+getAccelerationFactor(const std::string &units, json_t *event)
+{
+    if (units.size() == 0)
+        return 1.0;
+
+    bool fromGravity;
+    Units::UnitSystem fromUnits;
+    if (Units::ParseAccelerationUnit(units.c_str(), fromGravity, fromUnits) == false) {
+        std::cerr << "getAccelerationFactor - unknown acceleration units " << units << "\n";
+        return -1.0;
+    }
+
+    // the event motion is in g unless it gives its units
+    bool toGravity = true;
+    Units::UnitSystem toUnits;
+    json_t *eventUnits = json_object_get(event,"units");
+    const char *length = json_string_value(json_object_get(eventUnits,"length"));
+    const char *time = json_string_value(json_object_get(eventUnits,"time"));
+    if (length != NULL) {
+        toUnits.lengthUnit = Units::ParseLengthUnit(length);
+        toUnits.timeUnit = (time != NULL) ? Units::ParseTimeUnit(time) : Units::TimeUnit::Second;
+        toGravity = (toUnits.lengthUnit == Units::LengthUnit::Unknown ||
+                     toUnits.timeUnit == Units::TimeUnit::Unknown);
+    }
+
+    if (fromGravity == true)
+        return (toGravity == true) ? 1.0 : Units::GetGravity(toUnits);
+    if (toGravity == true)
+        return 1.0/Units::GetGravity(fromUnits);
+    return Units::GetAccelerationFactor(fromUnits, toUnits);
+}
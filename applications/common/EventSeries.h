@@ -0,0 +1,47 @@
+#ifndef EVENT_SERIES_H
+#define EVENT_SERIES_H
+
+#include <vector>
+#include <string>
+#include <jansson.h>
+
+//The EventSeries functions move ground motion records between the "timeSeries" entries
+//of an EVENT.json event and contiguous arrays of doubles
+
+struct EventSeries
+{
+    std::string name;
+    double dT = 0.0;
+    double factor = 1.0;
+    int dof = 0;                 // of the first pattern that applies the series
+    std::vector<double> data;
+};
+
+//This method reads the "Value" time series referenced by the patterns of a Seismic event, a
+//binary "dataFile" is found relative to the directory of the json file the event came from
+int readEventSeries(json_t *event, std::vector<EventSeries> &series, const char *filename = 0);
+
+//This method replaces data and dT of the timeSeries entry with the same name (data written
+//inline replaces a "dataFile" reference)
+int writeEventSeries(json_t *event, const EventSeries &series);
+
+//This method creates a Seismic event with one timeSeries and one UniformAcceleration
+//pattern per record, record i is applied to dofs[i]
+json_t *createSeismicEvent(const char *name,
+                           const std::vector<EventSeries> &series,
+                           const std::vector<int> &dofs);
+
+//This method reads a target spectrum file: {"periods":[..], "spectrum":[..], "damping":0.05,
+//"units":"g"}, units is left empty if the file has none
+int readTargetSpectrum(const char *filename,
+                       std::vector<double> &periods,
+                       std::vector<double> &spectrum,
+                       double &dampingRatio,
+                       std::string &units);
+
+//This method returns the factor from an acceleration in the given units ("g", "m/s^2",
+//"in/sec^2", ..) to the units of the motion of an event (its "units", g if it has none or the
+//event is null), 1 if no units are given and -1 if they are not known
+double getAccelerationFactor(const std::string &units, json_t *event);
+
+#endif
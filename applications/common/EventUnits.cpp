@@ -0,0 +1,93 @@
+#include <EventUnits.h>
+
+#include <jansson.h>
+#include <iostream>
+
+int
+readBIMUnits(const char *filenameBIM, Units::UnitSystem &bimUnits)
+{
+    json_error_t error;
+    json_t *rootBIM = json_load_file(filenameBIM, 0, &error);
+    if (rootBIM == NULL) {
+      std::cerr << "ERROR - could not parse " << filenameBIM << ": " << error.text << "\n";
+      return -1;
+    }
+
+    int found = 0;
+    json_t *units = json_object_get(json_object_get(rootBIM,"GeneralInformation"),"units");
+    const char *length = json_string_value(json_object_get(units,"length"));
+    const char *time = json_string_value(json_object_get(units,"time"));
+    if (length != NULL) {
+      bimUnits.lengthUnit = Units::ParseLengthUnit(length);
+      bimUnits.timeUnit = (time != NULL) ? Units::ParseTimeUnit(time) : Units::TimeUnit::Second;
+      found = (bimUnits.lengthUnit != Units::LengthUnit::Unknown &&
+	       bimUnits.timeUnit != Units::TimeUnit::Unknown) ? 1 : 0;
+    }
+
+    json_decref(rootBIM);
+    return found;
+}
+
+//
+// the units of the event, false if it has none or they are not known
+//
+
+static bool
+getEventUnits(const EventRecord &theEvent, Units::UnitSystem &eventUnits)
+{
+    if (theEvent.lengthUnit.size() == 0)
+      return false;
+
+    eventUnits.lengthUnit = Units::ParseLengthUnit(theEvent.lengthUnit.c_str());
+    eventUnits.timeUnit = (theEvent.timeUnit.size() != 0) ?
+      Units::ParseTimeUnit(theEvent.timeUnit.c_str()) : Units::TimeUnit::Second;
+    return (eventUnits.lengthUnit != Units::LengthUnit::Unknown &&
+	    eventUnits.timeUnit != Units::TimeUnit::Unknown);
+}
+
+void
+readEventUnits(json_t *event, EventRecord &theEvent)
+{
+    const char *name = json_string_value(json_object_get(event,"name"));
+    theEvent.name = (name != NULL) ? name : "";
+
+    json_t *units = json_object_get(event,"units");
+    const char *length = json_string_value(json_object_get(units,"length"));
+    const char *time = json_string_value(json_object_get(units,"time"));
+    theEvent.lengthUnit = (length != NULL) ? length : "";
+    theEvent.timeUnit = (time != NULL) ? time : "";
+}
+
+double
+getUnitConversionFactor(const EventRecord &theEvent, const Units::UnitSystem *toUnits)
+{
+    Units::UnitSystem SIUnits;
+    SIUnits.lengthUnit = Units::LengthUnit::Meter;
+    SIUnits.timeUnit = Units::TimeUnit::Second;
+
+    Units::UnitSystem eventUnits;
+    bool eventHasUnits = getEventUnits(theEvent, eventUnits);
+    if (eventHasUnits == false && theEvent.lengthUnit.size() != 0)
+      std::cerr << "Warning! Event " << theEvent.name << " units not known, assuming acceleration in g units" << std::endl;
+
+    Units::UnitSystem targetUnits = (toUnits != 0) ? *toUnits : SIUnits;
+
+    if (eventHasUnits == false)
+      return (toUnits != 0) ? Units::GetGravity(targetUnits) : 1.0;
+
+    double factor = Units::GetAccelerationFactor(eventUnits, targetUnits);
+    if (toUnits == 0)
+      factor /= Units::GetGravity(SIUnits);
+    return factor;
+}
+
+double
+getTimeConversionFactor(const EventRecord &theEvent, const Units::UnitSystem &toUnits)
+{
+    Units::UnitSystem eventUnits;
+    if (getEventUnits(theEvent, eventUnits) == false)
+      eventUnits.timeUnit = Units::TimeUnit::Second;
+
+    Units::UnitSystem targetUnits = toUnits;
+    return Units::GetTimeFactor(eventUnits, targetUnits);
+}
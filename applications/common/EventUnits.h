@@ -0,0 +1,26 @@
+#ifndef EVENT_UNITS_H
+#define EVENT_UNITS_H
+
+#include <Units.h>
+#include <EventReader.h>
+#include <jansson.h>
+
+//The units of the simulation applications: the motion of an event is in the event "units", in g
+//if it has none, and the EDPs are written in the units of the BIM (GeneralInformation "units").
+
+//This method reads the units of a BIM, returns 1 if it has them, 0 if not and -1 on error
+int readBIMUnits(const char *filenameBIM, Units::UnitSystem &bimUnits);
+
+//This method reads the name and "units" of an event of a json document into theEvent, for the
+//applications that change the events of an EVENT file rather than read them with EventReader
+void readEventUnits(json_t *event, EventRecord &theEvent);
+
+//This method returns the factor from the accelerations of an event to the given units, or to g
+//if no units are given
+double getUnitConversionFactor(const EventRecord &theEvent, const Units::UnitSystem *toUnits);
+
+//This method returns the factor from the time unit of an event (seconds if it has none) to the
+//given units
+double getTimeConversionFactor(const EventRecord &theEvent, const Units::UnitSystem &toUnits);
+
+#endif
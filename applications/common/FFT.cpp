@@ -0,0 +1,80 @@
+#include <FFT.h>
+#include <cmath>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+
+FFT::FFT(int size)
+    :n(nextPowerOfTwo(size))
+{
+    int numBits = 0;
+    while ((1 << numBits) < n)
+        numBits++;
+
+    bitReverse.resize(n);
+    for (int i=0; i<n; i++) {
+        int r = 0;
+        for (int b=0; b<numBits; b++)
+            if (i & (1 << b))
+                r |= 1 << (numBits - 1 - b);
+        bitReverse[i] = r;
+    }
+
+    twiddle.resize(n/2);
+    for (int k=0; k<n/2; k++)
+        twiddle[k] = std::complex<double>(cos(2.0*PI*k/n), -sin(2.0*PI*k/n));
+}
+
+int
+FFT::nextPowerOfTwo(int size)
+{
+    int p = 1;
+    while (p < size)
+        p <<= 1;
+    return p;
+}
+
+void
+FFT::forward(std::complex<double> *data) const
+{
+    this->transform(data, false);
+}
+
+void
+FFT::inverse(std::complex<double> *data) const
+{
+    this->transform(data, true);
+    double scale = 1.0/n;
+    for (int i=0; i<n; i++)
+        data[i] *= scale;
+}
+
+void
+FFT::transform(std::complex<double> *data, bool inverse) const
+{
+    for (int i=0; i<n; i++)
+        if (i < bitReverse[i])
+            std::swap(data[i], data[bitReverse[i]]);
+
+    //
+    // iterative butterflies, the twiddles of a stage of length len are every (n/len)th entry
+    //
+
+    for (int len=2; len<=n; len <<= 1) {
+        int half = len/2;
+        int stride = n/len;
+        for (int start=0; start<n; start+=len) {
+            std::complex<double> *a = data + start;
+            std::complex<double> *b = data + start + half;
+            for (int k=0; k<half; k++) {
+                // complex product written out, avoids the inf/nan checks of std::complex
+                double wr = twiddle[k*stride].real();
+                double wi = inverse ? -twiddle[k*stride].imag() : twiddle[k*stride].imag();
+                double br = b[k].real(), bi = b[k].imag();
+                std::complex<double> t(wr*br - wi*bi, wr*bi + wi*br);
+                b[k] = a[k] - t;
+                a[k] += t;
+            }
+        }
+    }
+}
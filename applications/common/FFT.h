@@ -0,0 +1,34 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <vector>
+#include <complex>
+
+//The FFT class is a radix-2 fast Fourier transform of a fixed power of two size. The twiddle
+//factors and the bit reversal permutation are computed once when the plan is created, so one
+//plan can be shared (read only, also between threads) by every transform of that size.
+class FFT
+{
+public:
+    FFT(int size);
+
+    int getSize(void) const {return n;}
+
+    //This method returns the smallest power of two not less than size
+    static int nextPowerOfTwo(int size);
+
+    //This method transforms the data in place, X[k] = sum x[j] exp(-2 pi i jk/n)
+    void forward(std::complex<double> *data) const;
+
+    //This method is the inverse of forward, including the 1/n scaling
+    void inverse(std::complex<double> *data) const;
+
+private:
+    void transform(std::complex<double> *data, bool inverse) const;
+
+    int n;
+    std::vector<int> bitReverse;
+    std::vector<std::complex<double> > twiddle;  // exp(-2 pi i k/n), k < n/2
+};
+
+#endif
@@ -0,0 +1,486 @@
+#include <GroundMotionModel.h>
+#include <jansson.h>
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+
+void
+ScenarioSet::add(double M, double Rjb, double theVs30, int theMechanism, double theWeight)
+{
+    if (theMechanism < Unspecified || theMechanism > Reverse)
+        theMechanism = Unspecified;
+
+    magnitude.push_back(M);
+    distance.push_back(Rjb);
+    vs30.push_back(theVs30);
+    mechanism.push_back(theMechanism);
+    weight.push_back(theWeight);
+}
+
+void
+ScenarioSet::clear(void)
+{
+    magnitude.clear();
+    distance.clear();
+    vs30.clear();
+    mechanism.clear();
+    weight.clear();
+}
+
+//
+// coefficient columns of the table file, a column with no default value is required
+//
+
+struct CoefficientColumn
+{
+    const char *name;
+    std::vector<double> GroundMotionModel::*column;
+    bool required;
+    double defaultValue;
+};
+
+GroundMotionModel::GroundMotionModel()
+{
+
+}
+
+GroundMotionModel::~GroundMotionModel()
+{
+
+}
+
+int
+GroundMotionModel::load(const char *filename)
+{
+    static const CoefficientColumn columns[] = {
+        {"e0", &GroundMotionModel::e0, true, 0.0},
+        {"e1", &GroundMotionModel::e1, true, 0.0},
+        {"e2", &GroundMotionModel::e2, true, 0.0},
+        {"e3", &GroundMotionModel::e3, true, 0.0},
+        {"e4", &GroundMotionModel::e4, true, 0.0},
+        {"e5", &GroundMotionModel::e5, true, 0.0},
+        {"e6", &GroundMotionModel::e6, true, 0.0},
+        {"Mh", &GroundMotionModel::Mh, true, 0.0},
+        {"c1", &GroundMotionModel::c1, true, 0.0},
+        {"c2", &GroundMotionModel::c2, true, 0.0},
+        {"c3", &GroundMotionModel::c3, true, 0.0},
+        {"Mref", &GroundMotionModel::Mref, false, 4.5},
+        {"Rref", &GroundMotionModel::Rref, false, 1.0},
+        {"h", &GroundMotionModel::h, true, 0.0},
+        {"Dc3", &GroundMotionModel::Dc3, false, 0.0},
+        {"c", &GroundMotionModel::c, true, 0.0},
+        {"Vc", &GroundMotionModel::Vc, true, 0.0},
+        {"Vref", &GroundMotionModel::Vref, false, 760.0},
+        {"f1", &GroundMotionModel::f1, false, 0.0},
+        {"f3", &GroundMotionModel::f3, false, 0.1},
+        {"f4", &GroundMotionModel::f4, true, 0.0},
+        {"f5", &GroundMotionModel::f5, true, 0.0},
+        {"R1", &GroundMotionModel::R1, true, 0.0},
+        {"R2", &GroundMotionModel::R2, true, 0.0},
+        {"DfR", &GroundMotionModel::DfR, true, 0.0},
+        {"DfV", &GroundMotionModel::DfV, true, 0.0},
+        {"V1", &GroundMotionModel::V1, true, 0.0},
+        {"V2", &GroundMotionModel::V2, true, 0.0},
+        {"phi1", &GroundMotionModel::phi1, true, 0.0},
+        {"phi2", &GroundMotionModel::phi2, true, 0.0},
+        {"tau1", &GroundMotionModel::tau1, true, 0.0},
+        {"tau2", &GroundMotionModel::tau2, true, 0.0}
+    };
+    int numColumns = sizeof(columns)/sizeof(CoefficientColumn);
+
+    json_error_t error;
+    json_t *root = json_load_file(filename, 0, &error);
+    if (root == NULL) {
+        std::cerr << "GroundMotionModel::load - could not parse " << filename << ": " << error.text << "\n";
+        return -1;
+    }
+
+    json_t *periodsArray = json_object_get(root,"periods");
+    int numRows = json_array_size(periodsArray);
+    if (numRows == 0) {
+        std::cerr << "GroundMotionModel::load - no periods in " << filename << "\n";
+        json_decref(root);
+        return -1;
+    }
+
+    tablePeriods.resize(numRows);
+    for (int k=0; k<numRows; k++)
+        tablePeriods[k] = json_number_value(json_array_get(periodsArray, k));
+
+    for (int j=0; j<numColumns; j++) {
+        std::vector<double> &theColumn = this->*(columns[j].column);
+        theColumn.assign(numRows, columns[j].defaultValue);
+
+        json_t *columnArray = json_object_get(root, columns[j].name);
+        if (columnArray == NULL && columns[j].required == false)
+            continue;
+        if ((int)json_array_size(columnArray) != numRows) {
+            std::cerr << "GroundMotionModel::load - coefficient " << columns[j].name
+                      << " missing or of wrong size in " << filename << "\n";
+            json_decref(root);
+            return -1;
+        }
+        for (int k=0; k<numRows; k++)
+            theColumn[k] = json_number_value(json_array_get(columnArray, k));
+    }
+
+    json_decref(root);
+    return numRows;
+}
+
+void
+GroundMotionModel::evaluateRow(int k, const ScenarioSet &scenarios, const double *pgaRock,
+                               double *lnY, double *sigma) const
+{
+    int numScenarios = scenarios.size();
+    const double *M = scenarios.magnitude.data();
+    const double *R = scenarios.distance.data();
+    const double *V = scenarios.vs30.data();
+    const int *mech = scenarios.mechanism.data();
+
+    const double eMech[4] = {e0[k], e1[k], e2[k], e3[k]};
+    const double theMh = Mh[k], theE4 = e4[k], theE5 = e5[k], theE6 = e6[k];
+    const double theC1 = c1[k], theC2 = c2[k], theC3 = c3[k] + Dc3[k];
+    const double theMref = Mref[k], theRref = Rref[k], h2 = h[k]*h[k];
+
+    //
+    // source and path terms; without pgaRock the reference rock (Vs30 = Vref) value is returned
+    //
+
+    for (int s=0; s<numScenarios; s++) {
+        double dM = M[s] - theMh;
+        double FE = eMech[mech[s]] + (dM <= 0.0 ? theE4*dM + theE5*dM*dM : theE6*dM);
+        double Rh = sqrt(R[s]*R[s] + h2);
+        double FP = (theC1 + theC2*(M[s] - theMref))*log(Rh/theRref) + theC3*(Rh - theRref);
+        lnY[s] = FE + FP;
+    }
+
+    if (pgaRock == 0)
+        return;
+
+    //
+    // linear and nonlinear site terms
+    //
+
+    const double theC = c[k], theVc = Vc[k], theVref = Vref[k];
+    const double theF1 = f1[k], theF3 = f3[k], theF4 = f4[k], theF5 = f5[k];
+    const double f5Ref = exp(theF5*(theVref - 360.0));
+
+    for (int s=0; s<numScenarios; s++) {
+        double Flin = theC*log(std::min(V[s], theVc)/theVref);
+        double f2 = theF4*(exp(theF5*(std::min(V[s], theVref) - 360.0)) - f5Ref);
+        double Fnl = theF1 + f2*log((pgaRock[s] + theF3)/theF3);
+        lnY[s] += Flin + Fnl;
+    }
+
+    if (sigma == 0)
+        return;
+
+    //
+    // aleatory variability, magnitude, distance and Vs30 dependent
+    //
+
+    const double thePhi1 = phi1[k], thePhi2 = phi2[k], theTau1 = tau1[k], theTau2 = tau2[k];
+    const double theR1 = R1[k], theR2 = R2[k], theDfR = DfR[k];
+    const double theV1 = V1[k], theV2 = V2[k], theDfV = DfV[k];
+    const double lnR21 = log(theR2/theR1), lnV21 = log(theV2/theV1);
+
+    for (int s=0; s<numScenarios; s++) {
+        double wM = std::min(std::max(M[s] - 4.5, 0.0), 1.0);
+        double tau = theTau1 + (theTau2 - theTau1)*wM;
+        double phi = thePhi1 + (thePhi2 - thePhi1)*wM;
+
+        double Rc = std::min(std::max(R[s], theR1), theR2);
+        phi += theDfR*log(Rc/theR1)/lnR21;
+
+        double Vclip = std::min(std::max(V[s], theV1), theV2);
+        phi -= theDfV*log(theV2/Vclip)/lnV21;
+
+        sigma[s] = sqrt(phi*phi + tau*tau);
+    }
+}
+
+int
+GroundMotionModel::evaluate(const ScenarioSet &scenarios,
+                            const std::vector<double> &periods,
+                            std::vector<double> &lnMean,
+                            std::vector<double> &sigma) const
+{
+    int numRows = tablePeriods.size();
+    int numPeriods = periods.size();
+    int numScenarios = scenarios.size();
+
+    //
+    // PGA row and ascending list of the spectral rows
+    //
+
+    int pgaRow = -1;
+    std::vector<int> rows;
+    for (int k=0; k<numRows; k++) {
+        if (tablePeriods[k] == 0.0)
+            pgaRow = k;
+        else if (tablePeriods[k] > 0.0)
+            rows.push_back(k);
+    }
+    std::sort(rows.begin(), rows.end(),
+              [this](int a, int b) {return tablePeriods[a] < tablePeriods[b];});
+
+    if (pgaRow < 0 || rows.size() == 0) {
+        std::cerr << "GroundMotionModel::evaluate - model table needs PGA and spectral periods\n";
+        return -1;
+    }
+
+    //
+    // bracketing rows & interpolation weight for each period, periods outside the table are clamped
+    //
+
+    std::vector<int> row0(numPeriods), row1(numPeriods);
+    std::vector<double> w1(numPeriods, 0.0);
+    int numSpectral = rows.size();
+
+    for (int i=0; i<numPeriods; i++) {
+        double T = periods[i];
+        if (T <= 0.0) {
+            row0[i] = row1[i] = pgaRow;
+        } else if (T <= tablePeriods[rows[0]]) {
+            row0[i] = row1[i] = rows[0];
+        } else if (T >= tablePeriods[rows[numSpectral-1]]) {
+            row0[i] = row1[i] = rows[numSpectral-1];
+        } else {
+            int j = 1;
+            while (tablePeriods[rows[j]] < T)
+                j++;
+            row0[i] = rows[j-1];
+            row1[i] = rows[j];
+            w1[i] = log(T/tablePeriods[row0[i]]) / log(tablePeriods[row1[i]]/tablePeriods[row0[i]]);
+        }
+    }
+
+    //
+    // rock PGA drives the nonlinear site term, then each table row needed is evaluated once
+    //
+
+    std::vector<double> pgaRock(numScenarios);
+    evaluateRow(pgaRow, scenarios, 0, pgaRock.data(), 0);
+    for (int s=0; s<numScenarios; s++)
+        pgaRock[s] = exp(pgaRock[s]);
+
+    std::vector<int> rowSlot(numRows, -1);
+    std::vector<double> rowMean, rowSigma;
+    for (int i=0; i<numPeriods; i++) {
+        int needed[2] = {row0[i], row1[i]};
+        for (int n=0; n<2; n++) {
+            int k = needed[n];
+            if (rowSlot[k] >= 0)
+                continue;
+            rowSlot[k] = rowMean.size() / std::max(numScenarios, 1);
+            rowMean.resize(rowMean.size() + numScenarios);
+            rowSigma.resize(rowSigma.size() + numScenarios);
+            double *lnY = &rowMean[rowSlot[k]*numScenarios];
+            double *sig = &rowSigma[rowSlot[k]*numScenarios];
+            evaluateRow(k, scenarios, pgaRock.data(), lnY, sig);
+        }
+    }
+
+    lnMean.resize(numPeriods*numScenarios);
+    sigma.resize(numPeriods*numScenarios);
+
+    for (int i=0; i<numPeriods; i++) {
+        const double *m0 = &rowMean[rowSlot[row0[i]]*numScenarios];
+        const double *m1 = &rowMean[rowSlot[row1[i]]*numScenarios];
+        const double *s0 = &rowSigma[rowSlot[row0[i]]*numScenarios];
+        const double *s1 = &rowSigma[rowSlot[row1[i]]*numScenarios];
+        double *mOut = &lnMean[i*numScenarios];
+        double *sOut = &sigma[i*numScenarios];
+        double w = w1[i];
+        for (int s=0; s<numScenarios; s++) {
+            mOut[s] = m0[s] + w*(m1[s] - m0[s]);
+            sOut[s] = s0[s] + w*(s1[s] - s0[s]);
+        }
+    }
+
+    return numPeriods;
+}
+
+double
+correlationBakerJayaram(double T1, double T2)
+{
+    double Tmin = std::min(T1, T2);
+    double Tmax = std::max(T1, T2);
+
+    double C1 = 1.0 - cos(PI/2.0 - 0.366*log(Tmax/std::max(Tmin, 0.109)));
+    double C2 = 0.0;
+    if (Tmax < 0.2)
+        C2 = 1.0 - 0.105*(1.0 - 1.0/(1.0 + exp(100.0*Tmax - 5.0)))*(Tmax - Tmin)/(Tmax - 0.0099);
+    double C3 = (Tmax < 0.109) ? C2 : C1;
+    double C4 = C1 + 0.5*(sqrt(C3) - C3)*(1.0 + cos(PI*Tmin/0.109));
+
+    if (Tmax < 0.109)
+        return C2;
+    else if (Tmin > 0.109)
+        return C1;
+    else if (Tmax < 0.2)
+        return std::min(C2, C4);
+    return C4;
+}
+
+ConditionalMeanSpectrum::ConditionalMeanSpectrum(const GroundMotionModel &model)
+    :theModel(model)
+{
+
+}
+
+ConditionalMeanSpectrum::~ConditionalMeanSpectrum()
+{
+
+}
+
+const std::vector<double> &
+ConditionalMeanSpectrum::getCorrelation(const std::vector<double> &periods)
+{
+    std::map<std::vector<double>, std::vector<double> >::iterator it = correlationCache.find(periods);
+    if (it != correlationCache.end())
+        return it->second;
+
+    int numPeriods = periods.size();
+    std::vector<double> &rho = correlationCache[periods];
+    rho.resize(numPeriods*numPeriods);
+
+    // PGA (period 0) is taken as the shortest period of the correlation model
+    for (int i=0; i<numPeriods; i++) {
+        rho[i*numPeriods+i] = 1.0;
+        double Ti = std::max(periods[i], 0.01);
+        for (int j=i+1; j<numPeriods; j++) {
+            double r = correlationBakerJayaram(Ti, std::max(periods[j], 0.01));
+            rho[i*numPeriods+j] = r;
+            rho[j*numPeriods+i] = r;
+        }
+    }
+
+    return rho;
+}
+
+int
+ConditionalMeanSpectrum::getEpsilon(const ScenarioSet &scenarios,
+                                    double conditioningPeriod,
+                                    double lnTargetSa,
+                                    std::vector<double> &epsilon) const
+{
+    std::vector<double> period(1, conditioningPeriod);
+    std::vector<double> mu, sigma;
+    if (theModel.evaluate(scenarios, period, mu, sigma) < 0)
+        return -1;
+
+    int numScenarios = scenarios.size();
+    epsilon.resize(numScenarios);
+    for (int s=0; s<numScenarios; s++)
+        epsilon[s] = (lnTargetSa - mu[s]) / sigma[s];
+
+    return numScenarios;
+}
+
+int
+ConditionalMeanSpectrum::compute(const ScenarioSet &scenarios,
+                                 const std::vector<double> &periods,
+                                 double conditioningPeriod,
+                                 const std::vector<double> &epsilon,
+                                 std::vector<double> &lnMean,
+                                 std::vector<double> &lnSigma,
+                                 std::vector<double> *covariance)
+{
+    int numPeriods = periods.size();
+    int numScenarios = scenarios.size();
+    bool conditioned = (conditioningPeriod > 0.0);
+
+    if (numScenarios == 0 || (conditioned && (int)epsilon.size() != numScenarios)) {
+        std::cerr << "ConditionalMeanSpectrum::compute - no scenarios or epsilon not given per scenario\n";
+        return -1;
+    }
+
+    double sumW = 0.0;
+    for (int s=0; s<numScenarios; s++)
+        sumW += scenarios.weight[s];
+    if (sumW <= 0.0) {
+        std::cerr << "ConditionalMeanSpectrum::compute - scenario weights sum to zero\n";
+        return -1;
+    }
+
+    //
+    // model at the periods (and the conditioning period, as the last row of the grid)
+    //
+
+    std::vector<double> grid(periods);
+    if (conditioned)
+        grid.push_back(conditioningPeriod);
+    int numGrid = grid.size();
+
+    std::vector<double> mu, sigma;
+    if (theModel.evaluate(scenarios, grid, mu, sigma) < 0)
+        return -1;
+
+    const std::vector<double> &rho = getCorrelation(grid);
+    std::vector<double> rhoStar(numPeriods, 0.0);
+    if (conditioned)
+        for (int i=0; i<numPeriods; i++)
+            rhoStar[i] = rho[i*numGrid + numPeriods];
+
+    //
+    // conditional mean of each scenario, mixture mean and variance over the scenarios
+    //
+
+    std::vector<double> cms(numPeriods*numScenarios);
+    lnMean.assign(numPeriods, 0.0);
+    lnSigma.assign(numPeriods, 0.0);
+
+    const double *w = scenarios.weight.data();
+    const double *eps = conditioned ? epsilon.data() : 0;
+
+    for (int i=0; i<numPeriods; i++) {
+        const double *m = &mu[i*numScenarios];
+        const double *sig = &sigma[i*numScenarios];
+        double *cm = &cms[i*numScenarios];
+        double r = rhoStar[i];
+
+        double sum = 0.0;
+        for (int s=0; s<numScenarios; s++) {
+            cm[s] = m[s] + (conditioned ? r*eps[s]*sig[s] : 0.0);
+            sum += w[s]*cm[s];
+        }
+        double mean = sum/sumW;
+
+        double var = 0.0;
+        for (int s=0; s<numScenarios; s++) {
+            double d = cm[s] - mean;
+            var += w[s]*(sig[s]*sig[s]*(1.0 - r*r) + d*d);
+        }
+
+        lnMean[i] = mean;
+        lnSigma[i] = sqrt(var/sumW);
+    }
+
+    if (covariance == 0)
+        return numPeriods;
+
+    covariance->assign(numPeriods*numPeriods, 0.0);
+    std::vector<double> &cov = *covariance;
+
+    for (int i=0; i<numPeriods; i++) {
+        const double *sigI = &sigma[i*numScenarios];
+        const double *cmI = &cms[i*numScenarios];
+        for (int j=i; j<numPeriods; j++) {
+            const double *sigJ = &sigma[j*numScenarios];
+            const double *cmJ = &cms[j*numScenarios];
+            double rc = rho[i*numGrid+j] - rhoStar[i]*rhoStar[j];
+            double sum = 0.0;
+            for (int s=0; s<numScenarios; s++)
+                sum += w[s]*(sigI[s]*sigJ[s]*rc + (cmI[s] - lnMean[i])*(cmJ[s] - lnMean[j]));
+            cov[i*numPeriods+j] = sum/sumW;
+            cov[j*numPeriods+i] = sum/sumW;
+        }
+    }
+
+    return numPeriods;
+}
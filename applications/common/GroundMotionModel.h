@@ -0,0 +1,97 @@
+#ifndef GROUND_MOTION_MODEL_H
+#define GROUND_MOTION_MODEL_H
+
+#include <vector>
+#include <map>
+
+//The ScenarioSet struct holds earthquake scenarios as separate arrays (one entry per
+//scenario) so ground motion models can be evaluated over all of them in one loop.
+//The weights are the scenario contributions, e.g. from a hazard deaggregation.
+struct ScenarioSet
+{
+    enum Mechanism {Unspecified = 0, StrikeSlip = 1, Normal = 2, Reverse = 3};
+
+    std::vector<double> magnitude;
+    std::vector<double> distance;   // Joyner-Boore distance, km
+    std::vector<double> vs30;       // m/s
+    std::vector<int> mechanism;
+    std::vector<double> weight;
+
+    void add(double M, double Rjb, double theVs30, int theMechanism, double theWeight);
+    void clear(void);
+    int size(void) const {return magnitude.size();}
+};
+
+//The GroundMotionModel class evaluates the Boore, Stewart, Seyhan & Atkinson (2014) model,
+//(basin term excluded) for all scenarios of a ScenarioSet at a set of periods. The model
+//coefficients are read from a JSON table {"periods":[..], "e0":[..], "e1":[..], ...}, one
+//array per coefficient with PGA given as period 0. Values at periods between the tabulated
+//ones are interpolated linearly in ln(period).
+class GroundMotionModel
+{
+public:
+    GroundMotionModel();
+    ~GroundMotionModel();
+
+    int load(const char *filename);
+
+    const std::vector<double> &getPeriods(void) const {return tablePeriods;}
+
+    //This method computes ln median Sa (g) and the total standard deviation of ln Sa for every
+    //scenario, the values for period i and scenario s are stored at [i*numScenarios + s]
+    int evaluate(const ScenarioSet &scenarios,
+                 const std::vector<double> &periods,
+                 std::vector<double> &lnMean,
+                 std::vector<double> &sigma) const;
+
+private:
+    void evaluateRow(int row, const ScenarioSet &scenarios, const double *pgaRock,
+                     double *lnY, double *sigma) const;
+
+    std::vector<double> tablePeriods;
+
+    // coefficients, one entry per table row
+    std::vector<double> e0, e1, e2, e3, e4, e5, e6, Mh;
+    std::vector<double> c1, c2, c3, Mref, Rref, h, Dc3;
+    std::vector<double> c, Vc, Vref, f1, f3, f4, f5;
+    std::vector<double> R1, R2, DfR, DfV, V1, V2, phi1, phi2, tau1, tau2;
+};
+
+//This method returns the Baker & Jayaram (2008) correlation of epsilon between two periods
+double correlationBakerJayaram(double T1, double T2);
+
+//The ConditionalMeanSpectrum class computes the conditional mean spectrum (and its standard
+//deviation) of a weighted set of scenarios given epsilon at a conditioning period. The
+//inter-period correlation matrix is cached for each period grid it is asked for.
+class ConditionalMeanSpectrum
+{
+public:
+    ConditionalMeanSpectrum(const GroundMotionModel &theModel);
+    ~ConditionalMeanSpectrum();
+
+    //This method returns the correlation matrix (row major) of the period grid
+    const std::vector<double> &getCorrelation(const std::vector<double> &periods);
+
+    //This method returns the epsilon of each scenario for which Sa(conditioningPeriod) = exp(lnTargetSa)
+    int getEpsilon(const ScenarioSet &scenarios,
+                   double conditioningPeriod,
+                   double lnTargetSa,
+                   std::vector<double> &epsilon) const;
+
+    //This method computes the scenario-weighted conditional mean and standard deviation of ln Sa,
+    //with no conditioning period (<= 0) the weighted unconditional mean is returned. If given, the
+    //conditional covariance of ln Sa (row major) is also returned.
+    int compute(const ScenarioSet &scenarios,
+                const std::vector<double> &periods,
+                double conditioningPeriod,
+                const std::vector<double> &epsilon,
+                std::vector<double> &lnMean,
+                std::vector<double> &lnSigma,
+                std::vector<double> *covariance = 0);
+
+private:
+    const GroundMotionModel &theModel;
+    std::map<std::vector<double>, std::vector<double> > correlationCache;
+};
+
+#endif
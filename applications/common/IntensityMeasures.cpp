@@ -0,0 +1,124 @@
+#include <IntensityMeasures.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+#define PI 3.14159265358979323846
+
+std::vector<double>
+getDefaultPeriods(void)
+{
+    const double periods[] = {0.1, 0.2, 0.3, 0.5, 0.75, 1.0, 1.5, 2.0, 3.0};
+    return std::vector<double>(periods, periods + sizeof(periods)/sizeof(double));
+}
+
+int
+parsePeriods(const char *list, std::vector<double> &periods)
+{
+    periods.clear();
+
+    if (list == 0)
+        return -1;
+
+    if (strcmp(list, "default") == 0) {
+        periods = getDefaultPeriods();
+        return periods.size();
+    }
+
+    const char *pos = list;
+    while (*pos != '\0') {
+        char *end;
+        double period = strtod(pos, &end);
+        if (end == pos || period <= 0.0) {
+            periods.clear();
+            return -1;
+        }
+        periods.push_back(period);
+
+        pos = end;
+        while (*pos == ',' || *pos == ' ')
+            pos++;
+    }
+
+    return periods.size();
+}
+
+std::string
+getSpectralType(double period)
+{
+    char type[32];
+    snprintf(type, sizeof(type), "SA_%g", period);
+    return std::string(type);
+}
+
+double
+getPeakVelocity(const double *accel, int numSteps, double dT)
+{
+    double velocity = 0.0;
+    double peak = 0.0;
+    for (int i=1; i<numSteps; i++) {
+        velocity += 0.5 * dT * (accel[i-1] + accel[i]);
+        if (fabs(velocity) > peak)
+            peak = fabs(velocity);
+    }
+    return peak;
+}
+
+double
+getPeakDisplacement(const double *accel, int numSteps, double dT)
+{
+    double velocity = 0.0;
+    double displacement = 0.0;
+    double peak = 0.0;
+    for (int i=1; i<numSteps; i++) {
+        double lastVelocity = velocity;
+        velocity += 0.5 * dT * (accel[i-1] + accel[i]);
+        displacement += 0.5 * dT * (lastVelocity + velocity);
+        if (fabs(displacement) > peak)
+            peak = fabs(displacement);
+    }
+    return peak;
+}
+
+double
+getAriasIntensity(const double *accel, int numSteps, double dT, double gravity)
+{
+    double sum = 0.0;
+    for (int i=0; i<numSteps; i++)
+        sum += accel[i] * accel[i];
+    return PI / (2.0 * gravity) * sum * dT;
+}
+
+double
+getSignificantDuration(const double *accel, int numSteps, double dT, double lower, double upper)
+{
+    double total = 0.0;
+    for (int i=0; i<numSteps; i++)
+        total += accel[i] * accel[i];
+    if (total == 0.0)
+        return 0.0;
+
+    //
+    // first steps at which the cumulative energy (Husid plot) passes each fraction
+    //
+
+    double lowerLevel = lower * total;
+    double upperLevel = upper * total;
+    int lowerStep = -1;
+    int upperStep = numSteps-1;
+
+    double sum = 0.0;
+    for (int i=0; i<numSteps; i++) {
+        sum += accel[i] * accel[i];
+        if (lowerStep < 0 && sum >= lowerLevel)
+            lowerStep = i;
+        if (sum >= upperLevel) {
+            upperStep = i;
+            break;
+        }
+    }
+
+    return (upperStep - lowerStep) * dT;
+}
@@ -0,0 +1,34 @@
+#ifndef INTENSITY_MEASURES_H
+#define INTENSITY_MEASURES_H
+
+#include <vector>
+#include <string>
+
+//Ground motion intensity measures written as EDPs by ExtractIMs (see EDPCatalog), the spectral
+//ordinates come from ResponseSpectrum. Period lists are comma separated, e.g. 0.2,0.5,1.0, or
+//"default" for the list below.
+
+//This method returns the default periods of the spectral ordinates
+std::vector<double> getDefaultPeriods(void);
+
+//This method parses a period list, returns the number of periods or -1 if it is not valid
+int parsePeriods(const char *list, std::vector<double> &periods);
+
+//This method returns the response type of the spectral ordinate at a period, e.g. "SA_0.2"
+std::string getSpectralType(double period);
+
+//This method returns the peak velocity, integrating the acceleration with the trapezoidal rule
+double getPeakVelocity(const double *accel, int numSteps, double dT);
+
+//This method returns the peak displacement, integrating the acceleration twice with the trapezoidal rule
+double getPeakDisplacement(const double *accel, int numSteps, double dT);
+
+//This method returns the Arias intensity pi/(2g) * integral of accel^2, accel and gravity in the same units
+double getAriasIntensity(const double *accel, int numSteps, double dT, double gravity);
+
+//This method returns the time between the lower and upper fractions of the Arias intensity
+//(the 5-95% significant duration by default)
+double getSignificantDuration(const double *accel, int numSteps, double dT,
+                              double lower = 0.05, double upper = 0.95);
+
+#endif
@@ -0,0 +1,447 @@
+#include <RecordSelection.h>
+#include <ResponseSpectrum.h>
+#include <EventSeries.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+#define INDEX_MAGIC "GMTSPIX3"
+
+SpectralIndex::SpectralIndex()
+    :dampingRatio(0.05)
+{
+
+}
+
+SpectralIndex::~SpectralIndex()
+{
+
+}
+
+int
+SpectralIndex::build(const std::vector<std::string> &eventFiles,
+                     const std::vector<double> &thePeriods,
+                     double theDampingRatio,
+                     int numThreads)
+{
+    periods = thePeriods;
+    dampingRatio = theDampingRatio;
+    files.clear();
+    seriesNames.clear();
+    eventIndexes.clear();
+    dofs.clear();
+    lnSa.clear();
+
+    int numPeriods = periods.size();
+    int numFiles = eventFiles.size();
+
+    //
+    // spectra of each file are computed by a pool of threads taking files in turn, then
+    // collected in file order so the index does not depend on the thread count
+    //
+
+    std::vector<std::vector<std::string> > fileSeries(numFiles);
+    std::vector<std::vector<int> > fileEvents(numFiles);
+    std::vector<std::vector<int> > fileDofs(numFiles);
+    std::vector<std::vector<float> > fileSpectra(numFiles);
+    std::atomic<int> nextFile(0);
+
+    auto worker = [&]() {
+        std::vector<EventSeries> theSeries;
+        std::vector<double> Sa(numPeriods);
+        int i;
+        while ((i = nextFile++) < numFiles) {
+            json_error_t error;
+            json_t *root = json_load_file(eventFiles[i].c_str(), 0, &error);
+            if (root == NULL) {
+                std::cerr << "SpectralIndex::build - could not parse " << eventFiles[i] << "\n";
+                continue;
+            }
+
+            json_t *eventsArray = json_object_get(root,"Events");
+            int numEvents = json_array_size(eventsArray);
+            for (int e=0; e<numEvents; e++) {
+                json_t *event = json_array_get(eventsArray, e);
+                if (readEventSeries(event, theSeries, eventFiles[i].c_str()) <= 0)
+                    continue;
+
+                // the spectra are kept in g
+                double toGravity = 1.0/getAccelerationFactor("g", event);
+
+                for (unsigned int s=0; s<theSeries.size(); s++) {
+                    EventSeries &theRecord = theSeries[s];
+                    ResponseSpectrum theSpectrum(periods, dampingRatio, theRecord.dT);
+                    theSpectrum.compute(theRecord.data.data(), theRecord.data.size(), 0, Sa.data());
+                    fileSeries[i].push_back(theRecord.name);
+                    fileEvents[i].push_back(e);
+                    fileDofs[i].push_back(theRecord.dof);
+                    double factor = fabs(theRecord.factor)*toGravity;
+                    for (int k=0; k<numPeriods; k++)
+                        fileSpectra[i].push_back(log(std::max(factor*Sa[k], 1.0e-12)));
+                }
+            }
+            json_decref(root);
+        }
+    };
+
+    if (numThreads < 1)
+        numThreads = 1;
+    std::vector<std::thread> threads;
+    for (int t=1; t<numThreads; t++)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (unsigned int t=0; t<threads.size(); t++)
+        threads[t].join();
+
+    for (int i=0; i<numFiles; i++) {
+        for (unsigned int s=0; s<fileSeries[i].size(); s++) {
+            files.push_back(eventFiles[i]);
+            seriesNames.push_back(fileSeries[i][s]);
+            eventIndexes.push_back(fileEvents[i][s]);
+            dofs.push_back(fileDofs[i][s]);
+        }
+        lnSa.insert(lnSa.end(), fileSpectra[i].begin(), fileSpectra[i].end());
+    }
+
+    return files.size();
+}
+
+//
+// index file: magic, int32 numRecords, int32 numPeriods, double damping, double periods[],
+// then per record uint16 length + file name, uint16 length + series name, int32 event index
+// & int32 dof, then the float ln(Sa) matrix (Sa in g), all in native byte order
+//
+
+static void writeString(FILE *fp, const std::string &theString)
+{
+    uint16_t length = theString.size();
+    fwrite(&length, sizeof(length), 1, fp);
+    fwrite(theString.data(), 1, length, fp);
+}
+
+static bool readString(FILE *fp, std::string &theString)
+{
+    uint16_t length = 0;
+    if (fread(&length, sizeof(length), 1, fp) != 1)
+        return false;
+    theString.resize(length);
+    return (length == 0 || fread(&theString[0], 1, length, fp) == length);
+}
+
+int
+SpectralIndex::save(const char *filename) const
+{
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        std::cerr << "SpectralIndex::save - could not open " << filename << "\n";
+        return -1;
+    }
+
+    int32_t numRecords = files.size();
+    int32_t numPeriods = periods.size();
+    fwrite(INDEX_MAGIC, 1, 8, fp);
+    fwrite(&numRecords, sizeof(numRecords), 1, fp);
+    fwrite(&numPeriods, sizeof(numPeriods), 1, fp);
+    fwrite(&dampingRatio, sizeof(double), 1, fp);
+    fwrite(periods.data(), sizeof(double), numPeriods, fp);
+    for (int i=0; i<numRecords; i++) {
+        writeString(fp, files[i]);
+        writeString(fp, seriesNames[i]);
+        int32_t eventIndex = eventIndexes[i];
+        int32_t dof = dofs[i];
+        fwrite(&eventIndex, sizeof(eventIndex), 1, fp);
+        fwrite(&dof, sizeof(dof), 1, fp);
+    }
+    fwrite(lnSa.data(), sizeof(float), lnSa.size(), fp);
+    fclose(fp);
+
+    return 0;
+}
+
+int
+SpectralIndex::load(const char *filename)
+{
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        std::cerr << "SpectralIndex::load - could not open " << filename << "\n";
+        return -1;
+    }
+
+    char magic[8];
+    int32_t numRecords = 0;
+    int32_t numPeriods = 0;
+    bool ok = (fread(magic, 1, 8, fp) == 8 && memcmp(magic, INDEX_MAGIC, 8) == 0);
+    ok = ok && fread(&numRecords, sizeof(numRecords), 1, fp) == 1;
+    ok = ok && fread(&numPeriods, sizeof(numPeriods), 1, fp) == 1;
+    ok = ok && numRecords >= 0 && numPeriods > 0;
+    ok = ok && fread(&dampingRatio, sizeof(double), 1, fp) == 1;
+    if (ok == true) {
+        periods.resize(numPeriods);
+        ok = fread(periods.data(), sizeof(double), numPeriods, fp) == (size_t)numPeriods;
+    }
+    if (ok == true) {
+        files.resize(numRecords);
+        seriesNames.resize(numRecords);
+        eventIndexes.resize(numRecords);
+        dofs.resize(numRecords);
+        for (int i=0; i<numRecords && ok == true; i++) {
+            int32_t eventIndex = 0;
+            int32_t dof = 0;
+            ok = readString(fp, files[i]) && readString(fp, seriesNames[i]);
+            ok = ok && fread(&eventIndex, sizeof(eventIndex), 1, fp) == 1;
+            ok = ok && fread(&dof, sizeof(dof), 1, fp) == 1;
+            eventIndexes[i] = eventIndex;
+            dofs[i] = dof;
+        }
+    }
+    if (ok == true) {
+        size_t size = (size_t)numRecords * numPeriods;
+        lnSa.resize(size);
+        ok = fread(lnSa.data(), sizeof(float), size, fp) == size;
+    }
+    fclose(fp);
+
+    if (ok == false) {
+        std::cerr << "SpectralIndex::load - " << filename << " is not a valid spectral index\n";
+        files.clear();
+        seriesNames.clear();
+        eventIndexes.clear();
+        dofs.clear();
+        lnSa.clear();
+        return -1;
+    }
+
+    return numRecords;
+}
+
+int
+SpectralIndex::select(const std::vector<double> &targetPeriods,
+                      const std::vector<double> &targetSa,
+                      const std::vector<double> &targetWeights,
+                      int numRecords,
+                      const SelectionOptions &options,
+                      std::vector<SelectedRecord> &selection) const
+{
+    selection.clear();
+
+    int numPeriods = periods.size();
+    int numRows = files.size();
+    int numTarget = targetPeriods.size();
+    if (numTarget == 0 || (int)targetSa.size() != numTarget || numRows == 0 || numRecords <= 0)
+        return -1;
+
+    // the misfit is in log, a target ordinate must be positive
+    for (int j=0; j<numTarget; j++) {
+        if (!(targetSa[j] > 0.0) || std::isinf(targetSa[j])) {
+            std::cerr << "SpectralIndex::select - target spectrum must be positive, it is "
+                      << targetSa[j] << " at period " << targetPeriods[j] << "\n";
+            return -1;
+        }
+    }
+    if (!targetWeights.empty() && (int)targetWeights.size() != numTarget) {
+        std::cerr << "SpectralIndex::select - " << targetWeights.size() << " weights given for "
+                  << numTarget << " target periods\n";
+        return -1;
+    }
+
+    //
+    // target & weights at the index periods, log-log interpolation, zero weight outside the target
+    //
+
+    std::vector<double> lnT(numPeriods, 0.0);
+    std::vector<double> w(numPeriods, 0.0);
+    double sumW = 0.0;
+    for (int k=0; k<numPeriods; k++) {
+        double T = periods[k];
+        for (int j=0; j<numTarget; j++) {
+            double T1 = targetPeriods[j];
+            double T2 = (j+1 < numTarget) ? targetPeriods[j+1] : T1;
+            if (T == T1 || (T > T1 && T < T2)) {
+                double w1 = targetWeights.empty() ? 1.0 : targetWeights[j];
+                if (T == T1) {
+                    lnT[k] = log(targetSa[j]);
+                    w[k] = w1;
+                } else {
+                    double w2 = targetWeights.empty() ? 1.0 : targetWeights[j+1];
+                    double x = log(T/T1)/log(T2/T1);
+                    lnT[k] = (1.0-x)*log(targetSa[j]) + x*log(targetSa[j+1]);
+                    w[k] = (1.0-x)*w1 + x*w2;
+                }
+                break;
+            }
+        }
+        sumW += w[k];
+    }
+    if (sumW <= 0.0) {
+        std::cerr << "SpectralIndex::select - target does not overlap the index periods\n";
+        return -1;
+    }
+
+    double tBar = 0.0;
+    double t2Bar = 0.0;
+    for (int k=0; k<numPeriods; k++) {
+        w[k] /= sumW;
+        tBar += w[k]*lnT[k];
+        t2Bar += w[k]*lnT[k]*lnT[k];
+    }
+
+    //
+    // optimal scale & misfit of every record: with d = lnT - lnSa the best ln(scale) is the
+    // weighted mean of d, so only three weighted sums over each row are needed
+    //
+
+    double lnMin = log(options.minScale);
+    double lnMax = log(options.maxScale);
+    std::vector<double> lnScale(numRows);
+    std::vector<double> misfit(numRows);
+
+    const double *wP = w.data();
+    const double *tP = lnT.data();
+    for (int r=0; r<numRows; r++) {
+        const float *x = &lnSa[(size_t)r*numPeriods];
+        double s1 = 0.0, s2 = 0.0, cross = 0.0;
+        for (int k=0; k<numPeriods; k++) {
+            double wx = wP[k]*x[k];
+            s1 += wx;
+            s2 += wx*x[k];
+            cross += wx*tP[k];
+        }
+        double sumD = tBar - s1;
+        double sumD2 = t2Bar - 2.0*cross + s2;
+        double lnS = sumD;
+        if (lnS < lnMin) lnS = lnMin;
+        if (lnS > lnMax) lnS = lnMax;
+        lnScale[r] = lnS;
+        misfit[r] = sumD2 - 2.0*lnS*sumD + lnS*lnS;
+    }
+
+    //
+    // candidate pool of the best individual matches
+    //
+
+    if (numRecords > numRows)
+        numRecords = numRows;
+    int poolSize = options.poolSize;
+    if (poolSize <= 0)
+        poolSize = std::max(20*numRecords, 200);
+    if (poolSize > numRows)
+        poolSize = numRows;
+
+    std::vector<int> pool(numRows);
+    for (int r=0; r<numRows; r++)
+        pool[r] = r;
+    std::partial_sort(pool.begin(), pool.begin()+poolSize, pool.end(),
+                      [&misfit](int a, int b) {return misfit[a] < misfit[b];});
+    pool.resize(poolSize);
+
+    // scaled ln spectra of the pool
+    std::vector<double> y((size_t)poolSize*numPeriods);
+    for (int p=0; p<poolSize; p++) {
+        const float *x = &lnSa[(size_t)pool[p]*numPeriods];
+        for (int k=0; k<numPeriods; k++)
+            y[(size_t)p*numPeriods+k] = x[k] + lnScale[pool[p]];
+    }
+
+    //
+    // suite objective: mean misfit of the records + suiteWeight * misfit of the suite mean,
+    // evaluated from the running sum of the members' scaled ln spectra
+    //
+
+    double lambda = options.suiteWeight;
+    std::vector<double> sum(numPeriods, 0.0);
+    double sumMisfit = 0.0;
+    std::vector<int> members;
+    std::vector<char> inSuite(poolSize, 0);
+
+    auto objective = [&](int add, int remove) {
+        int count = members.size() + (add >= 0 ? 1 : 0) - (remove >= 0 ? 1 : 0);
+        double total = sumMisfit;
+        if (add >= 0) total += misfit[pool[add]];
+        if (remove >= 0) total -= misfit[pool[remove]];
+        const double *yA = (add >= 0) ? &y[(size_t)add*numPeriods] : 0;
+        const double *yR = (remove >= 0) ? &y[(size_t)remove*numPeriods] : 0;
+        double suite = 0.0;
+        for (int k=0; k<numPeriods; k++) {
+            double m = sum[k];
+            if (yA != 0) m += yA[k];
+            if (yR != 0) m -= yR[k];
+            double d = m/count - tP[k];
+            suite += wP[k]*d*d;
+        }
+        return total/count + lambda*suite;
+    };
+
+    auto apply = [&](int add, int remove) {
+        for (int k=0; k<numPeriods; k++)
+            sum[k] += y[(size_t)add*numPeriods+k];
+        sumMisfit += misfit[pool[add]];
+        inSuite[add] = 1;
+        if (remove >= 0) {
+            for (int k=0; k<numPeriods; k++)
+                sum[k] -= y[(size_t)remove*numPeriods+k];
+            sumMisfit -= misfit[pool[remove]];
+            inSuite[remove] = 0;
+            *std::find(members.begin(), members.end(), remove) = add;
+        } else
+            members.push_back(add);
+    };
+
+    // greedy build up
+    for (int n=0; n<numRecords; n++) {
+        int best = -1;
+        double bestJ = 0.0;
+        for (int p=0; p<poolSize; p++) {
+            if (inSuite[p] != 0)
+                continue;
+            double J = objective(p, -1);
+            if (best < 0 || J < bestJ) {
+                best = p;
+                bestJ = J;
+            }
+        }
+        apply(best, -1);
+    }
+
+    // swap refinement, best improving swap per member until nothing improves
+    double currentJ = objective(-1, -1);
+    for (int pass=0; pass<options.maxSwapPasses; pass++) {
+        bool improved = false;
+        for (int m=0; m<numRecords; m++) {
+            int out = members[m];
+            int best = -1;
+            double bestJ = currentJ;
+            for (int p=0; p<poolSize; p++) {
+                if (inSuite[p] != 0)
+                    continue;
+                double J = objective(p, out);
+                if (J < bestJ - 1.0e-12) {
+                    best = p;
+                    bestJ = J;
+                }
+            }
+            if (best >= 0) {
+                apply(best, out);
+                currentJ = bestJ;
+                improved = true;
+            }
+        }
+        if (improved == false)
+            break;
+    }
+
+    for (unsigned int m=0; m<members.size(); m++) {
+        SelectedRecord theRecord;
+        theRecord.row = pool[members[m]];
+        theRecord.scale = exp(lnScale[theRecord.row]);
+        theRecord.misfit = misfit[theRecord.row];
+        selection.push_back(theRecord);
+    }
+
+    return selection.size();
+}
@@ -0,0 +1,74 @@
+#ifndef RECORD_SELECTION_H
+#define RECORD_SELECTION_H
+
+#include <vector>
+#include <string>
+
+//The SpectralIndex class holds the response spectra of a local record library as one
+//contiguous matrix of ln(Sa), Sa in g whatever the units of the records, a row per record component, so a target spectrum can be
+//compared against every candidate in a single pass. The index is built once from the
+//library's event files and saved to a compact binary file. A row names its component by
+//file, event index in the file, series name and the dof of the pattern applying it.
+
+struct SelectionOptions
+{
+    double minScale = 0.25;      // limits on the scale factor applied to a record
+    double maxScale = 4.0;
+    double suiteWeight = 1.0;    // weight of the suite mean misfit relative to the records' own
+    int poolSize = 0;            // candidates kept for the suite search, 0 = max(20*N, 200)
+    int maxSwapPasses = 10;
+};
+
+struct SelectedRecord
+{
+    int row;           // row in the index
+    double scale;      // optimal scale factor
+    double misfit;     // weighted mean squared ln misfit of the scaled record
+};
+
+class SpectralIndex
+{
+public:
+    SpectralIndex();
+    ~SpectralIndex();
+
+    //This method computes the spectra of every Value timeSeries in the event files
+    int build(const std::vector<std::string> &eventFiles,
+              const std::vector<double> &periods,
+              double dampingRatio,
+              int numThreads);
+
+    int save(const char *filename) const;
+    int load(const char *filename);
+
+    //This method finds the numRecords optimally scaled records that best match the target (in g),
+    //the target is interpolated (log-log) to the index periods; weights are per target period
+    int select(const std::vector<double> &targetPeriods,
+               const std::vector<double> &targetSa,
+               const std::vector<double> &weights,
+               int numRecords,
+               const SelectionOptions &options,
+               std::vector<SelectedRecord> &selection) const;
+
+    int getNumRecords(void) const {return files.size();}
+    int getNumPeriods(void) const {return periods.size();}
+    const std::vector<double> &getPeriods(void) const {return periods;}
+    double getDampingRatio(void) const {return dampingRatio;}
+    const std::string &getFile(int row) const {return files[row];}
+    const std::string &getSeriesName(int row) const {return seriesNames[row];}
+    int getEventIndex(int row) const {return eventIndexes[row];}
+    int getDof(int row) const {return dofs[row];}
+    const float *getLnSa(int row) const {return &lnSa[row*periods.size()];}
+
+private:
+    std::vector<double> periods;
+    double dampingRatio;
+
+    std::vector<std::string> files;
+    std::vector<std::string> seriesNames;
+    std::vector<int> eventIndexes;
+    std::vector<int> dofs;
+    std::vector<float> lnSa; // numRecords x numPeriods, row major
+};
+
+#endif
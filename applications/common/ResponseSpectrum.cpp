@@ -0,0 +1,145 @@
+#include <ResponseSpectrum.h>
+#include <cmath>
+
+#define PI 3.14159265358979323846
+
+ResponseSpectrum::ResponseSpectrum(const std::vector<double> &thePeriods, double theDampingRatio, double theDT)
+    :numPeriods(thePeriods.size()), periods(thePeriods), dampingRatio(theDampingRatio), dT(theDT)
+{
+    omega.resize(numPeriods);
+    A.resize(numPeriods); B.resize(numPeriods); C.resize(numPeriods); D.resize(numPeriods);
+    Ap.resize(numPeriods); Bp.resize(numPeriods); Cp.resize(numPeriods); Dp.resize(numPeriods);
+
+    //
+    // piecewise exact coefficients for u'' + 2 zeta w u' + w^2 u = p, unit mass
+    //  (same as LinearInterpolation() in timeIntegrators.cpp)
+    //
+
+    double zeta = dampingRatio;
+    double zeta2 = zeta*zeta;
+    double sqrtZ = sqrt(1.0 - zeta2);
+
+    for (int i=0; i<numPeriods; i++) {
+        double w = 2.0 * PI / periods[i];
+        double k = w*w;
+        double wD = w * sqrtZ;
+        double e_pow = exp(-zeta * w * dT);
+        double sin_freq = sin(wD * dT);
+        double cos_freq = cos(wD * dT);
+
+        omega[i] = w;
+        A[i] = e_pow * (zeta / sqrtZ * sin_freq + cos_freq);
+        B[i] = e_pow * sin_freq / wD;
+        C[i] = (2.0 * zeta / (w * dT) +
+                e_pow * (((1.0 - 2.0 * zeta2) / (wD * dT) - zeta / sqrtZ) * sin_freq -
+                         (1.0 + 2.0 * zeta / (w * dT)) * cos_freq)) / k;
+        D[i] = (1.0 - 2.0 * zeta / (w * dT) +
+                e_pow * ((2.0 * zeta2 - 1.0) / (wD * dT) * sin_freq +
+                         2.0 * zeta / (w * dT) * cos_freq)) / k;
+
+        Ap[i] = -e_pow * (w * sin_freq / sqrtZ);
+        Bp[i] = e_pow * (cos_freq - zeta * sin_freq / sqrtZ);
+        Cp[i] = (-1.0 / dT + e_pow * ((w / sqrtZ + zeta / (dT * sqrtZ)) * sin_freq
+                                      + cos_freq / dT)) / k;
+        Dp[i] = (1.0 - e_pow * (zeta * sin_freq / sqrtZ + cos_freq)) / (k * dT);
+    }
+}
+
+void
+ResponseSpectrum::compute(const double *accel, int numSteps,
+                          double *Sd, double *Sa,
+                          int *peakStep, double *peakDisp) const
+{
+    //
+    // state of all oscillators, advanced together one step at a time
+    //
+
+    std::vector<double> u(numPeriods, 0.0);
+    std::vector<double> v(numPeriods, 0.0);
+    std::vector<double> uMax(numPeriods, 0.0);
+    std::vector<double> uPeak(numPeriods, 0.0);
+    std::vector<int> stepMax(numPeriods, 0);
+
+    double *uP = u.data();
+    double *vP = v.data();
+    double *uMaxP = uMax.data();
+    double *uPeakP = uPeak.data();
+    int *stepMaxP = stepMax.data();
+
+    for (int n=1; n<numSteps; n++) {
+        double forceP = -accel[n-1];
+        double forceC = -accel[n];
+        for (int i=0; i<numPeriods; i++) {
+            double uC = A[i]*uP[i] + B[i]*vP[i] + C[i]*forceP + D[i]*forceC;
+            vP[i] = Ap[i]*uP[i] + Bp[i]*vP[i] + Cp[i]*forceP + Dp[i]*forceC;
+            uP[i] = uC;
+
+            double absU = fabs(uC);
+            bool isPeak = absU > uMaxP[i];
+            uMaxP[i] = isPeak ? absU : uMaxP[i];
+            uPeakP[i] = isPeak ? uC : uPeakP[i];
+            stepMaxP[i] = isPeak ? n : stepMaxP[i];
+        }
+    }
+
+    for (int i=0; i<numPeriods; i++) {
+        if (Sd != 0)
+            Sd[i] = uMax[i];
+        if (Sa != 0)
+            Sa[i] = uMax[i] * omega[i] * omega[i];
+        if (peakStep != 0)
+            peakStep[i] = stepMax[i];
+        if (peakDisp != 0)
+            peakDisp[i] = uPeak[i];
+    }
+}
+
+void
+ResponseSpectrum::history(int i, const double *accel, int numSteps, double *disp) const
+{
+    if (numSteps <= 0)
+        return;
+
+    double a = A[i], b = B[i], c = C[i], d = D[i];
+    double ap = Ap[i], bp = Bp[i], cp = Cp[i], dp = Dp[i];
+
+    double uP = 0.0;
+    double vP = 0.0;
+    disp[0] = 0.0;
+
+    for (int n=1; n<numSteps; n++) {
+        double forceP = -accel[n-1];
+        double forceC = -accel[n];
+        double uC = a*uP + b*vP + c*forceP + d*forceC;
+        vP = ap*uP + bp*vP + cp*forceP + dp*forceC;
+        uP = uC;
+        disp[n] = uC;
+    }
+}
+
+void
+ResponseSpectrum::histories(const double *accel, int numSteps, double *disp) const
+{
+    if (numSteps <= 0)
+        return;
+
+    std::vector<double> u(numPeriods, 0.0);
+    std::vector<double> v(numPeriods, 0.0);
+    double *uP = u.data();
+    double *vP = v.data();
+
+    for (int i=0; i<numPeriods; i++)
+        disp[i*numSteps] = 0.0;
+
+    for (int n=1; n<numSteps; n++) {
+        double forceP = -accel[n-1];
+        double forceC = -accel[n];
+        for (int i=0; i<numPeriods; i++) {
+            double uC = A[i]*uP[i] + B[i]*vP[i] + C[i]*forceP + D[i]*forceC;
+            vP[i] = Ap[i]*uP[i] + Bp[i]*vP[i] + Cp[i]*forceP + Dp[i]*forceC;
+            uP[i] = uC;
+        }
+        for (int i=0; i<numPeriods; i++)
+            disp[i*numSteps + n] = uP[i];
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef RESPONSE_SPECTRUM_H
+#define RESPONSE_SPECTRUM_H
+
+#include <vector>
+
+//The ResponseSpectrum class computes elastic SDOF spectra for a set of periods using the
+//piecewise exact (Nigam-Jennings) recurrence. The recurrence coefficients for every period
+//are computed once in the constructor and stored as contiguous arrays, so the time loop
+//can advance all the oscillators together.
+class ResponseSpectrum
+{
+public:
+    ResponseSpectrum(const std::vector<double> &periods, double dampingRatio, double dT);
+
+    int getNumPeriods(void) const {return numPeriods;}
+    const std::vector<double> &getPeriods(void) const {return periods;}
+    double getDampingRatio(void) const {return dampingRatio;}
+    double getTimeStep(void) const {return dT;}
+    double getOmega(int periodIndex) const {return omega[periodIndex];}
+
+    //This method computes the peak relative displacement and the pseudo acceleration
+    //(omega^2 * Sd, same units as the motion) at all periods. If peakStep or peakDisp
+    //are given the step at which the peak occurs and the signed displacement there are returned
+    void compute(const double *accel, int numSteps,
+                 double *Sd, double *Sa,
+                 int *peakStep = 0, double *peakDisp = 0) const;
+
+    //This method returns the full relative displacement history of a single oscillator
+    void history(int periodIndex, const double *accel, int numSteps, double *disp) const;
+
+    //This method returns the displacement histories of all oscillators, the history
+    //for period i is stored at disp[i*numSteps]
+    void histories(const double *accel, int numSteps, double *disp) const;
+
+private:
+    int numPeriods;
+    std::vector<double> periods;
+    double dampingRatio;
+    double dT;
+
+    // recurrence coefficients, one entry per period
+    std::vector<double> omega;
+    std::vector<double> A, B, C, D;
+    std::vector<double> Ap, Bp, Cp, Dp;
+};
+
+#endif
@@ -0,0 +1,95 @@
+#include <SeriesReduction.h>
+#include <cmath>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+double
+getPeakAbsolute(const double *data, int numSteps)
+{
+    int i = 0;
+    double peak = 0.0;
+
+#if defined(__AVX__)
+
+    //
+    // four lanes, two accumulators; the sign bit is cleared with an and-not
+    //
+
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    __m256d max0 = _mm256_setzero_pd();
+    __m256d max1 = _mm256_setzero_pd();
+    for (; i+8 <= numSteps; i+=8) {
+        max0 = _mm256_max_pd(max0, _mm256_andnot_pd(signMask, _mm256_loadu_pd(data+i)));
+        max1 = _mm256_max_pd(max1, _mm256_andnot_pd(signMask, _mm256_loadu_pd(data+i+4)));
+    }
+    max0 = _mm256_max_pd(max0, max1);
+    __m128d max2 = _mm_max_pd(_mm256_castpd256_pd128(max0), _mm256_extractf128_pd(max0, 1));
+    max2 = _mm_max_sd(max2, _mm_unpackhi_pd(max2, max2));
+    peak = _mm_cvtsd_f64(max2);
+
+#elif defined(USE_SSE2)
+
+    //
+    // two lanes, four accumulators
+    //
+
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    __m128d max0 = _mm_setzero_pd();
+    __m128d max1 = _mm_setzero_pd();
+    __m128d max2 = _mm_setzero_pd();
+    __m128d max3 = _mm_setzero_pd();
+    for (; i+8 <= numSteps; i+=8) {
+        max0 = _mm_max_pd(max0, _mm_andnot_pd(signMask, _mm_loadu_pd(data+i)));
+        max1 = _mm_max_pd(max1, _mm_andnot_pd(signMask, _mm_loadu_pd(data+i+2)));
+        max2 = _mm_max_pd(max2, _mm_andnot_pd(signMask, _mm_loadu_pd(data+i+4)));
+        max3 = _mm_max_pd(max3, _mm_andnot_pd(signMask, _mm_loadu_pd(data+i+6)));
+    }
+    max0 = _mm_max_pd(_mm_max_pd(max0, max1), _mm_max_pd(max2, max3));
+    max0 = _mm_max_sd(max0, _mm_unpackhi_pd(max0, max0));
+    peak = _mm_cvtsd_f64(max0);
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+    float64x2_t max0 = vdupq_n_f64(0.0);
+    float64x2_t max1 = vdupq_n_f64(0.0);
+    for (; i+4 <= numSteps; i+=4) {
+        max0 = vmaxq_f64(max0, vabsq_f64(vld1q_f64(data+i)));
+        max1 = vmaxq_f64(max1, vabsq_f64(vld1q_f64(data+i+2)));
+    }
+    peak = vmaxvq_f64(vmaxq_f64(max0, max1));
+
+#else
+
+    //
+    // no SIMD: four independent running maxima so the compares can overlap
+    //
+
+    double max0 = 0.0, max1 = 0.0, max2 = 0.0, max3 = 0.0;
+    for (; i+4 <= numSteps; i+=4) {
+        double a0 = fabs(data[i]), a1 = fabs(data[i+1]), a2 = fabs(data[i+2]), a3 = fabs(data[i+3]);
+        max0 = (a0 > max0) ? a0 : max0;
+        max1 = (a1 > max1) ? a1 : max1;
+        max2 = (a2 > max2) ? a2 : max2;
+        max3 = (a3 > max3) ? a3 : max3;
+    }
+    max0 = (max1 > max0) ? max1 : max0;
+    max2 = (max3 > max2) ? max3 : max2;
+    peak = (max2 > max0) ? max2 : max0;
+
+#endif
+
+    // remainder
+    for (; i<numSteps; i++) {
+        double absValue = fabs(data[i]);
+        peak = (absValue > peak) ? absValue : peak;
+    }
+
+    return peak;
+}
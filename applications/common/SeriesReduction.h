@@ -0,0 +1,12 @@
+#ifndef SERIES_REDUCTION_H
+#define SERIES_REDUCTION_H
+
+//Reductions over contiguous sample buffers. The peak is found with SIMD max-abs (AVX or SSE2
+//on x86, NEON on arm64, whichever the build targets, unrolled scalar code otherwise); the
+//callers fold any constant factors on the samples (series factor, unit conversion) into one
+//scale applied to the peak instead of to every sample.
+
+//This method returns the largest absolute value of the samples, 0 if there are none
+double getPeakAbsolute(const double *data, int numSteps);
+
+#endif
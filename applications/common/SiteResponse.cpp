@@ -0,0 +1,168 @@
+#include <SiteResponse.h>
+#include <FFT.h>
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+
+typedef std::complex<double> Complex;
+
+// complex shear wave velocity for hysteretic damping, G* = G (1 - 2 xi^2 + 2 i xi sqrt(1 - xi^2))
+static Complex
+complexVelocity(double shearVelocity, double modulusRatio, double xi)
+{
+    Complex factor(1.0 - 2.0*xi*xi, 2.0*xi*sqrt(1.0 - xi*xi));
+    return shearVelocity*sqrt(modulusRatio)*std::sqrt(factor);
+}
+
+SiteResponse::SiteResponse(const std::vector<SoilLayer> &theLayers,
+                           double theRockShearVelocity, double theRockDensity, double theRockDamping)
+    :layers(theLayers), rockShearVelocity(theRockShearVelocity),
+     rockDensity(theRockDensity), rockDamping(theRockDamping)
+{
+    int numLayers = layers.size();
+    strain.assign(numLayers, 0.0);
+    modulusRatio.assign(numLayers, 1.0);
+    damping.resize(numLayers);
+    for (int m=0; m<numLayers; m++)
+        damping[m] = layers[m].minDamping;
+}
+
+int
+SiteResponse::compute(const double *accel, int numSteps, double dT,
+                      double *surface, const SiteResponseOptions &options)
+{
+    int numLayers = layers.size();
+
+    FFT thePlan(2*numSteps);
+    int n = thePlan.getSize();
+    int numFreq = n/2 + 1;
+
+    //
+    // input spectrum, computed once for all iterations, and the input displacement (m)
+    //
+
+    std::vector<Complex> inputSpectrum(n, Complex(0.0, 0.0));
+    for (int j=0; j<numSteps; j++)
+        inputSpectrum[j] = Complex(accel[j], 0.0);
+    thePlan.forward(inputSpectrum.data());
+
+    std::vector<double> omega(numFreq);
+    std::vector<Complex> inputDisp(numFreq, Complex(0.0, 0.0));
+    for (int k=0; k<numFreq; k++) {
+        omega[k] = 2.0*PI*k/(n*dT);
+        if (k != 0)
+            inputDisp[k] = -inputSpectrum[k]*options.gravity/(omega[k]*omega[k]);
+    }
+
+    //
+    // up and down going wave amplitudes at the top of the current layer, with unit amplitudes
+    // at the free surface, and the mid-depth strain transfer function of every layer
+    //
+
+    std::vector<Complex> A(numFreq), B(numFreq);
+    std::vector<Complex> strainTF(numLayers*numFreq);
+    std::vector<Complex> work(n);
+    std::vector<Complex> velocity(numLayers + 1);
+
+    for (int m=0; m<numLayers; m++) {
+        strain[m] = 0.0;
+        modulusRatio[m] = 1.0;
+        damping[m] = layers[m].minDamping;
+    }
+
+    bool converged = false;
+    int iter = 0;
+
+    while (converged == false && iter < options.maxIterations) {
+        iter++;
+
+        for (int m=0; m<numLayers; m++)
+            velocity[m] = complexVelocity(layers[m].shearVelocity, modulusRatio[m], damping[m]);
+        velocity[numLayers] = complexVelocity(rockShearVelocity, 1.0, rockDamping);
+
+        std::fill(A.begin(), A.end(), Complex(1.0, 0.0));
+        std::fill(B.begin(), B.end(), Complex(1.0, 0.0));
+
+        for (int m=0; m<numLayers; m++) {
+            double below = (m+1 < numLayers) ? layers[m+1].density : rockDensity;
+            Complex alpha = (layers[m].density*velocity[m]) / (below*velocity[m+1]);
+            Complex plus = 0.5*(1.0 + alpha);
+            Complex minus = 0.5*(1.0 - alpha);
+
+            // i k z = omega q z with q = i / Vs*
+            Complex q = Complex(0.0, 1.0)/velocity[m];
+            double halfH = 0.5*layers[m].thickness;
+            Complex *theStrain = &strainTF[m*numFreq];
+
+            for (int k=0; k<numFreq; k++) {
+                Complex ik = omega[k]*q;
+                Complex E = std::exp(ik*halfH);
+                Complex Einv = 1.0/E;
+
+                theStrain[k] = ik*(A[k]*E - B[k]*Einv);
+
+                Complex Ab = A[k]*E*E;
+                Complex Bb = B[k]*Einv*Einv;
+                A[k] = plus*Ab + minus*Bb;
+                B[k] = minus*Ab + plus*Bb;
+            }
+        }
+
+        //
+        // peak strain at each mid-depth for the outcrop input (outcrop motion = 2 A at the rock)
+        //
+
+        double maxChange = 0.0;
+
+        for (int m=0; m<numLayers; m++) {
+            const Complex *theStrain = &strainTF[m*numFreq];
+            for (int k=0; k<numFreq; k++)
+                work[k] = theStrain[k]*inputDisp[k]/(2.0*A[k]);
+            for (int k=numFreq; k<n; k++)
+                work[k] = std::conj(work[n-k]);
+            thePlan.inverse(work.data());
+
+            double peak = 0.0;
+            for (int j=0; j<numSteps; j++)
+                peak = std::max(peak, fabs(work[j].real()));
+
+            const SoilLayer &theLayer = layers[m];
+            strain[m] = options.strainRatio*peak;
+            double ratio = 1.0/(1.0 + pow(strain[m]/theLayer.referenceStrain, theLayer.curvature));
+            double xi = theLayer.minDamping + (theLayer.maxDamping - theLayer.minDamping)*(1.0 - ratio);
+
+            maxChange = std::max(maxChange, fabs(ratio - modulusRatio[m])/ratio);
+            maxChange = std::max(maxChange, fabs(xi - damping[m])/xi);
+
+            modulusRatio[m] = ratio;
+            damping[m] = xi;
+        }
+
+        if (maxChange < options.tolerance)
+            converged = true;
+    }
+
+    //
+    // surface motion, u(surface) = A + B = 2 at the free surface
+    //
+
+    for (int k=0; k<numFreq; k++)
+        work[k] = inputSpectrum[k]/A[k];
+    for (int k=numFreq; k<n; k++)
+        work[k] = std::conj(work[n-k]);
+    thePlan.inverse(work.data());
+
+    for (int j=0; j<numSteps; j++)
+        surface[j] = work[j].real();
+
+    if (converged == false) {
+        std::cerr << "SiteResponse::compute - not converged in " << options.maxIterations << " iterations\n";
+        return -1;
+    }
+
+    return iter;
+}
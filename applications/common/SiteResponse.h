@@ -0,0 +1,59 @@
+#ifndef SITE_RESPONSE_H
+#define SITE_RESPONSE_H
+
+#include <vector>
+
+//The SiteResponse class propagates an outcropping rock motion vertically through a layered
+//soil column with the frequency domain equivalent-linear method (SHAKE). Each iteration
+//computes the transfer functions of all layers in one sweep of the wave recursion, the strain
+//histories at the layer mid-depths, and updates the strain compatible modulus and damping
+//from hyperbolic curves. The Fourier transform of the input motion is computed once.
+
+struct SoilLayer
+{
+    double thickness;             // m
+    double shearVelocity;         // small strain, m/s
+    double density;               // kg/m^3
+    double referenceStrain = 0.001; // G/Gmax = 1/(1 + (strain/referenceStrain)^curvature)
+    double curvature = 1.0;
+    double minDamping = 0.01;     // damping ratio, small strain
+    double maxDamping = 0.20;     // damping ratio as G/Gmax -> 0
+};
+
+struct SiteResponseOptions
+{
+    int maxIterations = 15;
+    double tolerance = 0.01;      // relative change of modulus and damping in all layers
+    double strainRatio = 0.65;    // effective / peak strain
+    double gravity = 9.81;        // m/s^2 per unit of input acceleration (input in g)
+};
+
+class SiteResponse
+{
+public:
+    SiteResponse(const std::vector<SoilLayer> &layers,
+                 double rockShearVelocity, double rockDensity, double rockDamping);
+
+    //This method computes the surface motion (in the units of the input) for an outcropping
+    //rock input motion, returns the number of iterations or -1 if not converged
+    int compute(const double *accel, int numSteps, double dT,
+                double *surface, const SiteResponseOptions &options);
+
+    int getNumLayers(void) const {return layers.size();}
+    double getEffectiveStrain(int layer) const {return strain[layer];}
+    double getModulusRatio(int layer) const {return modulusRatio[layer];}
+    double getDamping(int layer) const {return damping[layer];}
+
+private:
+    std::vector<SoilLayer> layers;
+    double rockShearVelocity;
+    double rockDensity;
+    double rockDamping;
+
+    // strain compatible properties, one entry per layer
+    std::vector<double> strain;
+    std::vector<double> modulusRatio;
+    std::vector<double> damping;
+};
+
+#endif
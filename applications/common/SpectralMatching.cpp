@@ -0,0 +1,428 @@
+#include <SpectralMatching.h>
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+
+// cost of one oscillator step relative to one multiply-add of a stored response
+#define INTEGRATION_COST 4.0
+
+SpectralMatcher::SpectralMatcher(const std::vector<double> &periods,
+                                 const std::vector<double> &targetSa,
+                                 double dampingRatio,
+                                 double theDT,
+                                 int theNumSteps)
+    :theSpectrum(periods, dampingRatio, theDT), target(targetSa),
+     numPeriods(periods.size()), numSteps(theNumSteps), dT(theDT),
+     builtCutoff(0.0), maxMemoryMB(512), regularization(0.1), misfit(0.0), rmsMisfit(0.0)
+{
+
+}
+
+SpectralMatcher::~SpectralMatcher()
+{
+
+}
+
+void
+SpectralMatcher::buildWavelets(double cutoff)
+{
+    halfWidth.resize(numPeriods);
+    lag.resize(numPeriods);
+    wavelets.resize(numPeriods);
+
+    //
+    // tapered cosine with Hancock et al (2006) taper, minus a wider gaussian scaled so the
+    // discrete wavelet sums to zero; being symmetric it then adds no velocity or displacement drift.
+    // The wavelet is centred lag steps ahead of the peak it corrects, the delay of the damped
+    // oscillator response, so that the wavelet matrix is diagonally dominant
+    //
+
+    double zeta = theSpectrum.getDampingRatio();
+
+    for (int j=0; j<numPeriods; j++) {
+        double f = 1.0/theSpectrum.getPeriods()[j];
+        double w = 2.0 * PI * f;
+        double gamma = 1.178 * pow(f, -0.93);
+        int L = ceil(3.0 * gamma / dT);
+        if (L > numSteps)
+            L = numSteps;
+        halfWidth[j] = L;
+
+        double wD = w * sqrt(1.0 - zeta*zeta);
+        double delay = (zeta > 0.0) ? atan(sqrt(1.0 - zeta*zeta)/zeta)/wD : 0.5*PI/w;
+        lag[j] = floor(delay/dT + 0.5);
+
+        std::vector<double> &wavelet = wavelets[j];
+        wavelet.resize(2*L+1);
+        std::vector<double> correction(2*L+1);
+        double sumW = 0.0;
+        double sumC = 0.0;
+        for (int n=-L; n<=L; n++) {
+            double t = n*dT;
+            double taper = exp(-(t/gamma)*(t/gamma));
+            wavelet[n+L] = cos(w*t) * taper;
+            correction[n+L] = exp(-(t/(1.5*gamma))*(t/(1.5*gamma)));
+            sumW += wavelet[n+L];
+            sumC += correction[n+L];
+        }
+        double c = sumW/sumC;
+        for (int n=0; n<2*L+1; n++)
+            wavelet[n] -= c*correction[n];
+    }
+
+    //
+    // response of every oscillator to every wavelet, from one step before the wavelet starts;
+    // the free vibration tail is cut where the damped envelope drops below cutoff and the
+    // length is limited so the whole table stays within the memory budget
+    //
+
+    size_t budget = maxMemoryMB * 1.0e6 / sizeof(double);
+    size_t lengthLimit = budget / (numPeriods*numPeriods > 0 ? numPeriods*numPeriods : 1);
+    if (lengthLimit < 16)
+        lengthLimit = 16;
+
+    responses.resize(numPeriods*numPeriods);
+    std::vector<size_t> lengths(numPeriods);
+    std::vector<double> input;
+    std::vector<double> response;
+
+    for (int j=0; j<numPeriods; j++) {
+        int L = halfWidth[j];
+        size_t maxLength = 0;
+        for (int i=0; i<numPeriods; i++) {
+            size_t length = numSteps;
+            if (zeta > 0.0) {
+                double tail = log(1.0/cutoff) / (zeta * theSpectrum.getOmega(i) * dT);
+                if (tail + 2*L + 2 < length)
+                    length = tail + 2*L + 2;
+            }
+            if (length > lengthLimit)
+                length = lengthLimit;
+            lengths[i] = length;
+            if (length > maxLength)
+                maxLength = length;
+        }
+
+        input.assign(maxLength, 0.0);
+        for (int n=0; n<2*L+1 && n+1<(int)maxLength; n++)
+            input[n+1] = wavelets[j][n];
+
+        response.resize(numPeriods*maxLength);
+        theSpectrum.histories(input.data(), maxLength, response.data());
+
+        for (int i=0; i<numPeriods; i++) {
+            const double *h = &response[i*maxLength];
+            responses[j*numPeriods + i].assign(h, h + lengths[i]);
+        }
+    }
+}
+
+void
+SpectralMatcher::resync(const std::vector<double> &accel)
+{
+    disp.resize(numPeriods*numSteps);
+    theSpectrum.histories(accel.data(), numSteps, disp.data());
+}
+
+void
+SpectralMatcher::findPeaks(void)
+{
+    peakStep.resize(numPeriods);
+    peakDisp.resize(numPeriods);
+    Sa.resize(numPeriods);
+
+    for (int i=0; i<numPeriods; i++) {
+        const double *u = &disp[i*numSteps];
+        double uMax = 0.0;
+        int stepMax = 0;
+        for (int n=0; n<numSteps; n++) {
+            double absU = fabs(u[n]);
+            if (absU > uMax) {
+                uMax = absU;
+                stepMax = n;
+            }
+        }
+        double w = theSpectrum.getOmega(i);
+        peakStep[i] = stepMax;
+        peakDisp[i] = u[stepMax];
+        Sa[i] = uMax * w * w;
+    }
+}
+
+double
+SpectralMatcher::computeMisfit(void)
+{
+    misfit = 0.0;
+    double sumSq = 0.0;
+    for (int i=0; i<numPeriods; i++) {
+        double err = fabs(Sa[i]/target[i] - 1.0);
+        if (err > misfit)
+            misfit = err;
+        sumSq += err*err;
+    }
+    rmsMisfit = sqrt(sumSq/numPeriods);
+    return misfit;
+}
+
+int
+SpectralMatcher::solve(std::vector<double> &C, std::vector<double> &b, int n)
+{
+    //
+    // gaussian elimination with partial pivoting; the diagonal is strengthened because
+    // closely spaced periods have wide, overlapping wavelets & a near singular matrix
+    //
+
+    for (int i=0; i<n; i++)
+        C[i*n+i] *= (1.0 + regularization);
+
+    for (int k=0; k<n; k++) {
+        int pivot = k;
+        for (int i=k+1; i<n; i++)
+            if (fabs(C[i*n+k]) > fabs(C[pivot*n+k]))
+                pivot = i;
+        if (C[pivot*n+k] == 0.0)
+            return -1;
+        if (pivot != k) {
+            for (int j=0; j<n; j++)
+                std::swap(C[k*n+j], C[pivot*n+j]);
+            std::swap(b[k], b[pivot]);
+        }
+        for (int i=k+1; i<n; i++) {
+            double factor = C[i*n+k]/C[k*n+k];
+            for (int j=k; j<n; j++)
+                C[i*n+j] -= factor*C[k*n+j];
+            b[i] -= factor*b[k];
+        }
+    }
+
+    for (int k=n-1; k>=0; k--) {
+        double sum = b[k];
+        for (int j=k+1; j<n; j++)
+            sum -= C[k*n+j]*b[j];
+        b[k] = sum/C[k*n+k];
+    }
+
+    return 0;
+}
+
+bool
+SpectralMatcher::addWavelets(std::vector<double> &accel, const std::vector<double> &b,
+                             const std::vector<int> &center, double gain,
+                             std::vector<char> *truncated)
+{
+    bool anyTruncated = false;
+
+    for (int j=0; j<numPeriods; j++) {
+        double amp = gain * b[j];
+        if (amp == 0.0)
+            continue;
+        int L = halfWidth[j];
+        int start = center[j] - L;
+        if (start - 1 < 0)
+            anyTruncated = true;
+        if (truncated != 0)
+            (*truncated)[j] = (start - 1 < 0);
+        // the part of the wavelet within the record, the pointers only formed inside it
+        int nFirst = start < 0 ? -start : 0;
+        int nLast = 2*L+1;
+        if (start + nLast > numSteps)
+            nLast = numSteps - start;
+        if (nLast <= nFirst)
+            continue;
+        const double *wavelet = wavelets[j].data() + nFirst;
+        double *a = accel.data() + (start + nFirst);
+        for (int n=0; n<nLast-nFirst; n++)
+            a[n] += amp * wavelet[n];
+    }
+
+    return anyTruncated;
+}
+
+int
+SpectralMatcher::match(std::vector<double> &accel, const SpectralMatchOptions &options)
+{
+    if ((int)target.size() != numPeriods || (int)accel.size() != numSteps || numPeriods == 0) {
+        std::cerr << "SpectralMatcher::match - target, periods and record sizes do not agree\n";
+        return -1;
+    }
+
+    for (int i=0; i<numPeriods; i++) {
+        if (!(target[i] > 0.0) || std::isinf(target[i])) {
+            std::cerr << "SpectralMatcher::match - target spectrum must be positive, it is "
+                      << target[i] << " at period " << theSpectrum.getPeriods()[i] << "\n";
+            return -1;
+        }
+    }
+
+    maxMemoryMB = options.maxMemoryMB;
+    if (wavelets.size() == 0 || builtCutoff != options.responseCutoff) {
+        this->buildWavelets(options.responseCutoff);
+        builtCutoff = options.responseCutoff;
+    }
+
+    this->resync(accel);
+    this->findPeaks();
+
+    //
+    // scale the record first so the wavelets only have to correct the spectral shape
+    //
+
+    if (options.scaleFirst == true) {
+        double sumLog = 0.0;
+        int numLog = 0;
+        for (int i=0; i<numPeriods; i++) {
+            if (Sa[i] > 0.0 && target[i] > 0.0) {
+                sumLog += log(target[i]/Sa[i]);
+                numLog++;
+            }
+        }
+        if (numLog != 0) {
+            double scale = exp(sumLog/numLog);
+            for (int n=0; n<numSteps; n++)
+                accel[n] *= scale;
+            for (int n=0; n<numPeriods*numSteps; n++)
+                disp[n] *= scale;
+            this->findPeaks();
+        }
+    }
+
+    this->computeMisfit();
+
+    std::vector<int> active;
+    std::vector<double> C, rhs, b;
+
+    std::vector<int> center(numPeriods);
+    std::vector<char> truncated(numPeriods);
+    double gain = options.gain;
+    regularization = options.regularization;
+
+    int iter = 0;
+    while (iter < options.maxIterations && misfit > options.tolerance) {
+
+        //
+        // only periods still outside the tolerance get a wavelet, so late iterations touch few
+        // periods and the superposition below gets cheap. For these the change in peak
+        // displacement needed & the response at each peak time to the other wavelets
+        //
+
+        for (int j=0; j<numPeriods; j++)
+            center[j] = peakStep[j] - lag[j];
+
+        active.clear();
+        for (int i=0; i<numPeriods; i++)
+            if (Sa[i] > 0.0 && fabs(Sa[i]/target[i] - 1.0) > options.tolerance)
+                active.push_back(i);
+        int numActive = active.size();
+
+        // the periods out of tolerance have no response to scale, the wavelets cannot reach them
+        if (numActive == 0) {
+            std::cerr << "SpectralMatcher::match - no response at the periods still out of tolerance\n";
+            break;
+        }
+
+        C.resize(numActive*numActive);
+        rhs.resize(numActive);
+        for (int a=0; a<numActive; a++) {
+            int i = active[a];
+            rhs[a] = peakDisp[i]*(target[i]/Sa[i] - 1.0);
+            for (int c=0; c<numActive; c++) {
+                int j = active[c];
+                const std::vector<double> &response = responses[j*numPeriods + i];
+                int r = peakStep[i] - (center[j] - halfWidth[j] - 1);
+                C[a*numActive + c] = (r >= 0 && r < (int)response.size()) ? response[r] : 0.0;
+            }
+        }
+
+        if (this->solve(C, rhs, numActive) != 0) {
+            std::cerr << "SpectralMatcher::match - singular wavelet matrix at iteration " << iter << "\n";
+            break;
+        }
+
+        b.assign(numPeriods, 0.0);
+        for (int a=0; a<numActive; a++)
+            b[active[a]] = rhs[a];
+
+        //
+        // add the wavelets to the record
+        //
+
+        this->addWavelets(accel, b, center, gain, &truncated);
+        iter++;
+
+        //
+        // update the oscillator histories by superposing the stored wavelet responses, unless
+        // integrating the record again is cheaper (long responses relative to the record), a
+        // wavelet was cut off by the start of the record (no stored response for it) or it
+        // is time for an exact pass to remove the error of the truncated tails
+        //
+
+        bool doResync = (options.resyncInterval > 0 && iter % options.resyncInterval == 0);
+        double superposeCost = 0.0;
+        for (int j=0; j<numPeriods && doResync == false; j++) {
+            if (gain * b[j] == 0.0)
+                continue;
+            if (truncated[j] != 0)
+                doResync = true;
+            for (int i=0; i<numPeriods; i++)
+                superposeCost += responses[j*numPeriods + i].size();
+        }
+        if (superposeCost > INTEGRATION_COST * numPeriods * numSteps)
+            doResync = true;
+
+        if (doResync == true) {
+            this->resync(accel);
+        } else {
+            for (int j=0; j<numPeriods; j++) {
+                double amp = gain * b[j];
+                if (amp == 0.0)
+                    continue;
+                int base = center[j] - halfWidth[j] - 1;
+                for (int i=0; i<numPeriods; i++) {
+                    const std::vector<double> &response = responses[j*numPeriods + i];
+                    int length = response.size();
+                    if (base + length > numSteps)
+                        length = numSteps - base;
+                    const double *h = response.data();
+                    double *u = &disp[i*numSteps + base];
+                    for (int r=0; r<length; r++)
+                        u[r] += amp * h[r];
+                }
+            }
+        }
+
+        this->findPeaks();
+
+        //
+        // if the linearisation failed (peaks moved too far) take the step back and halve it,
+        // otherwise let the step grow back
+        //
+
+        double lastMisfit = rmsMisfit;
+        this->computeMisfit();
+        if (rmsMisfit > lastMisfit) {
+            this->addWavelets(accel, b, center, -gain, 0);
+            this->resync(accel);
+            this->findPeaks();
+            this->computeMisfit();
+            gain *= 0.5;
+            if (gain < 1.0e-3 * options.gain)
+                break;
+        } else if (gain < options.gain) {
+            gain *= 1.5;
+            if (gain > options.gain)
+                gain = options.gain;
+        }
+    }
+
+    //
+    // final exact pass so reported spectrum & misfit are not affected by truncated responses
+    //
+
+    this->resync(accel);
+    this->findPeaks();
+    this->computeMisfit();
+
+    return iter;
+}
@@ -0,0 +1,83 @@
+#ifndef SPECTRAL_MATCHING_H
+#define SPECTRAL_MATCHING_H
+
+#include <vector>
+#include <ResponseSpectrum.h>
+
+//The SpectralMatcher class modifies an acceleration record in the time domain so that its
+//response spectrum matches a target spectrum, by adding baseline corrected tapered cosine
+//wavelets at the times of the oscillator peaks (in the spirit of Lilhanand & Tseng, Hancock et al).
+//
+//The oscillator responses to each wavelet are computed once; an iteration then updates the
+//stored oscillator histories by superposing the shifted wavelet responses instead of
+//integrating every oscillator over the whole record again. A full re-integration is done
+//every resyncInterval iterations (and at the end) to remove the error from the truncated
+//wavelet responses.
+
+struct SpectralMatchOptions
+{
+    double tolerance = 0.1;       // stop when max |Sa/target - 1| below this
+    int maxIterations = 30;
+    double gain = 1.0;            // relaxation applied to the wavelet amplitudes
+    double regularization = 0.1;  // relative increase of the wavelet matrix diagonal
+    bool scaleFirst = true;       // scale the record to the target before adding wavelets
+    int resyncInterval = 5;       // exact re-integration every n iterations
+    double responseCutoff = 1e-3; // relative amplitude at which wavelet responses are truncated
+    double maxMemoryMB = 512;     // limit on the stored wavelet responses, longer tails are cut
+};
+
+class SpectralMatcher
+{
+public:
+    SpectralMatcher(const std::vector<double> &periods,
+                    const std::vector<double> &targetSa,
+                    double dampingRatio,
+                    double dT,
+                    int numSteps);
+    ~SpectralMatcher();
+
+    //This method matches the record in place, it returns the number of iterations or -1 on error
+    int match(std::vector<double> &accel, const SpectralMatchOptions &options);
+
+    //These methods return the state after the last call to match()
+    double getMisfit(void) const {return misfit;}
+    const std::vector<double> &getSpectrum(void) const {return Sa;}
+
+private:
+    void buildWavelets(double cutoff);
+    void resync(const std::vector<double> &accel);
+    void findPeaks(void);
+    double computeMisfit(void);
+    int solve(std::vector<double> &C, std::vector<double> &b, int n);
+    bool addWavelets(std::vector<double> &accel, const std::vector<double> &b,
+                     const std::vector<int> &center, double gain,
+                     std::vector<char> *truncated);
+
+    ResponseSpectrum theSpectrum;
+    std::vector<double> target;
+    int numPeriods;
+    int numSteps;
+    double dT;
+
+    // wavelet j is stored for steps -halfWidth[j] .. halfWidth[j] about its centre
+    std::vector<int> halfWidth;
+    std::vector<int> lag;
+    std::vector<std::vector<double> > wavelets;
+
+    // response of oscillator i to wavelet j, starting one step before the wavelet,
+    // stored at responses[j*numPeriods + i]
+    std::vector<std::vector<double> > responses;
+    double builtCutoff;
+    double maxMemoryMB;
+    double regularization;
+
+    // current oscillator histories, history of period i at disp[i*numSteps]
+    std::vector<double> disp;
+    std::vector<int> peakStep;
+    std::vector<double> peakDisp;
+    std::vector<double> Sa;
+    double misfit;
+    double rmsMisfit;
+};
+
+#endif
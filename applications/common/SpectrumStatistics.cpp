@@ -0,0 +1,203 @@
+#include <SpectrumStatistics.h>
+
+#include <cmath>
+#include <algorithm>
+
+QuantileSketch::QuantileSketch(double alpha, int bins)
+    : maxBins(bins), count(0.0), zeroCount(0.0), minIndex(0)
+{
+    gamma = (1.0+alpha)/(1.0-alpha);
+    logGamma = log(gamma);
+    if (maxBins < 1)
+        maxBins = 1;
+}
+
+int
+QuantileSketch::getIndex(double value) const
+{
+    return int(ceil(log(value)/logGamma));
+}
+
+//
+// makes room for the bin of an index, merging the lowest bins into the new lowest if there would
+// be more than maxBins
+//
+
+void
+QuantileSketch::grow(int index)
+{
+    if (bins.empty()) {
+        minIndex = index;
+        bins.assign(1, 0.0);
+        return;
+    }
+
+    int maxIndex = minIndex + int(bins.size()) - 1;
+    if (index > maxIndex)
+        bins.resize(index - minIndex + 1, 0.0);
+    else if (index < minIndex) {
+        bins.insert(bins.begin(), minIndex - index, 0.0);
+        minIndex = index;
+    }
+
+    if (int(bins.size()) > maxBins) {
+        int numMerged = bins.size() - maxBins;
+        double merged = 0.0;
+        for (int i=0; i<=numMerged; i++)
+            merged += bins[i];
+        bins.erase(bins.begin(), bins.begin() + numMerged);
+        bins[0] = merged;
+        minIndex += numMerged;
+    }
+}
+
+void
+QuantileSketch::add(double value)
+{
+    // as in the log statistics, there is no bin for an inf and a nan has no rank
+    if (!std::isfinite(value))
+        return;
+
+    count += 1.0;
+    if (!(value > 0.0)) {
+        zeroCount += 1.0;
+        return;
+    }
+
+    int index = getIndex(value);
+    if (bins.empty() || index < minIndex || index >= minIndex + int(bins.size()))
+        this->grow(index);
+    bins[std::max(0, index - minIndex)] += 1.0;
+}
+
+bool
+QuantileSketch::merge(const QuantileSketch &other)
+{
+    // the bin indexes of sketches with different gammas are not of the same values
+    if (!this->isCompatible(other))
+        return false;
+    if (other.count == 0.0)
+        return true;
+
+    count += other.count;
+    zeroCount += other.zeroCount;
+    if (other.bins.empty())
+        return true;
+
+    this->grow(other.minIndex);
+    this->grow(other.minIndex + int(other.bins.size()) - 1);
+    for (unsigned int i=0; i<other.bins.size(); i++)
+        bins[std::max(0, other.minIndex + int(i) - minIndex)] += other.bins[i];
+    return true;
+}
+
+double
+QuantileSketch::getQuantile(double q) const
+{
+    if (count == 0.0)
+        return 0.0;
+
+    double rank = std::max(0.0, std::min(1.0, q))*(count-1.0);
+    if (rank < zeroCount)
+        return 0.0;
+
+    double cumulative = zeroCount;
+    for (unsigned int i=0; i<bins.size(); i++) {
+        cumulative += bins[i];
+        if (cumulative > rank)
+            return 2.0*pow(gamma, minIndex + int(i))/(gamma + 1.0);
+    }
+    return 2.0*pow(gamma, minIndex + int(bins.size()) - 1)/(gamma + 1.0);
+}
+
+SpectrumStatistics::SpectrumStatistics(int numPeriods)
+    : numSpectra(0)
+{
+    this->clear(numPeriods);
+}
+
+void
+SpectrumStatistics::clear(int numPeriods)
+{
+    Period thePeriod;
+    thePeriod.count = 0.0;
+    thePeriod.mean = 0.0;
+    thePeriod.sumSquares = 0.0;
+    periods.assign(numPeriods, thePeriod);
+    numSpectra = 0;
+}
+
+void
+SpectrumStatistics::add(const double *values)
+{
+    for (unsigned int i=0; i<periods.size(); i++) {
+        Period &thePeriod = periods[i];
+        double value = values[i];
+        thePeriod.sketch.add(value);
+        if (value > 0.0 && std::isfinite(value)) {
+            double logValue = log(value);
+            thePeriod.count += 1.0;
+            double delta = logValue - thePeriod.mean;
+            thePeriod.mean += delta/thePeriod.count;
+            thePeriod.sumSquares += delta*(logValue - thePeriod.mean);
+        }
+    }
+    numSpectra++;
+}
+
+//
+// the means and sums of squares of two parts combined as in Chan, Golub and LeVeque
+//
+
+bool
+SpectrumStatistics::merge(const SpectrumStatistics &other)
+{
+    if (other.numSpectra == 0)
+        return true;
+    if (numSpectra == 0) {
+        *this = other;
+        return true;
+    }
+    if (other.periods.size() != periods.size())
+        return false;
+
+    // checked for all before any are merged, so a mismatch leaves these as they were
+    for (unsigned int i=0; i<periods.size(); i++)
+        if (!periods[i].sketch.isCompatible(other.periods[i].sketch))
+            return false;
+
+    for (unsigned int i=0; i<periods.size(); i++) {
+        Period &thePeriod = periods[i];
+        const Period &otherPeriod = other.periods[i];
+        thePeriod.sketch.merge(otherPeriod.sketch);
+        if (otherPeriod.count == 0.0)
+            continue;
+
+        double count = thePeriod.count + otherPeriod.count;
+        double delta = otherPeriod.mean - thePeriod.mean;
+        thePeriod.mean += delta*otherPeriod.count/count;
+        thePeriod.sumSquares += otherPeriod.sumSquares + delta*delta*thePeriod.count*otherPeriod.count/count;
+        thePeriod.count = count;
+    }
+    numSpectra += other.numSpectra;
+    return true;
+}
+
+double
+SpectrumStatistics::getLogMean(int period) const
+{
+    return periods[period].mean;
+}
+
+double
+SpectrumStatistics::getLogStdDev(int period) const
+{
+    const Period &thePeriod = periods[period];
+    return (thePeriod.count > 1.0) ? sqrt(thePeriod.sumSquares/(thePeriod.count-1.0)) : 0.0;
+}
+
+double
+SpectrumStatistics::getQuantile(int period, double p) const
+{
+    return periods[period].sketch.getQuantile(p);
+}
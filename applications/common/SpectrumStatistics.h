@@ -0,0 +1,83 @@
+#ifndef SPECTRUM_STATISTICS_H
+#define SPECTRUM_STATISTICS_H
+
+#include <vector>
+
+//The QuantileSketch keeps the quantiles of a stream of values to a relative accuracy alpha, in a
+//fixed amount of memory whatever the number of values (a DDSketch): the positive values are
+//counted in bins whose bounds grow by gamma = (1+alpha)/(1-alpha), bin i holding the values in
+//(gamma^(i-1), gamma^i], the rest in one bin for 0. When there are more than maxBins the lowest
+//are merged, losing accuracy only at the low end. Two sketches with the same alpha merge exactly.
+class QuantileSketch
+{
+public:
+    QuantileSketch(double alpha = 0.01, int maxBins = 2048);
+
+    //This method adds a value, one that is not finite (inf, nan) is left out
+    void add(double value);
+
+    //This method adds the values of another sketch, returning false and leaving this one as it
+    //is if the two do not have the same gamma
+    bool merge(const QuantileSketch &other);
+    bool isCompatible(const QuantileSketch &other) const {return gamma == other.gamma;}
+
+    double getCount(void) const {return count;}
+
+    //This method returns the q quantile (q in [0,1]), 0 if there are no values
+    double getQuantile(double q) const;
+
+private:
+    int getIndex(double value) const;
+    void grow(int index);
+
+    double gamma;
+    double logGamma;
+    int maxBins;
+
+    double count;
+    double zeroCount;               // values <= 0
+    int minIndex;                   // the index of bins[0]
+    std::vector<double> bins;
+};
+
+//The SpectrumStatistics accumulates the spectra of a suite of motions, one period at a time,
+//without keeping them: the mean and standard deviation of the log of the values by Welford's
+//method, and a QuantileSketch of the values for the median and the other percentiles. The
+//statistics of parts of the suite, gathered apart, merge into those of the whole.
+class SpectrumStatistics
+{
+public:
+    SpectrumStatistics(int numPeriods = 0);
+
+    void clear(int numPeriods);
+
+    //This method adds a spectrum, its values at each of the periods
+    void add(const double *values);
+
+    //This method adds the statistics of another part of the suite, returning false and leaving
+    //these as they are if the periods or the sketch accuracies differ
+    bool merge(const SpectrumStatistics &other);
+
+    int getNumPeriods(void) const {return periods.size();}
+    int getNumSpectra(void) const {return numSpectra;}
+
+    //These methods return the statistics at a period: the mean and standard deviation (the
+    //dispersion) of the log of the positive values, the p quantile (p in [0,1]) of the values
+    double getLogMean(int period) const;
+    double getLogStdDev(int period) const;
+    double getQuantile(int period, double p) const;
+
+private:
+    struct Period
+    {
+        double count;               // of the positive values, those with a log
+        double mean;
+        double sumSquares;          // of the differences from the mean
+        QuantileSketch sketch;
+    };
+
+    std::vector<Period> periods;
+    int numSpectra;
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include <StochasticMotion.h>
+
+#include <cmath>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#define PI 3.14159265358979323846
+#define GRAVITY_CM 980.665
+
+// record length relative to the Saragoni-Hart window length
+#define RECORD_LENGTH_FACTOR 1.2
+
+StochasticMotion::StochasticMotion(const StochasticParameters &theParameters)
+    :parameters(theParameters), dT(theParameters.dT),
+     thePlan(0)
+{
+    const StochasticParameters &p = parameters;
+
+    //
+    // Brune source: seismic moment (dyne-cm) & corner frequency, source + path duration
+    //
+
+    double M0 = pow(10.0, 1.5*p.magnitude + 16.05);
+    double fc = 4.906e6 * p.shearVelocity * pow(p.stressDrop/M0, 1.0/3.0);
+    duration = 1.0/fc + 0.05*p.distance;
+
+    //
+    // Saragoni-Hart window (epsilon = 0.2, eta = 0.05) reaching eta at twice the duration
+    //
+
+    double epsilon = 0.2;
+    double eta = 0.05;
+    double tEta = 2.0*duration;
+    double b = -epsilon*log(eta) / (1.0 + epsilon*(log(epsilon) - 1.0));
+    double c = b/epsilon;
+    double a = pow(exp(1.0)/epsilon, b);
+
+    numSteps = (int)ceil(RECORD_LENGTH_FACTOR*tEta/dT) + 1;
+    window.resize(numSteps);
+    for (int j=0; j<numSteps; j++) {
+        double t = j*dT/tEta;
+        window[j] = a*pow(t, b)*exp(-c*t);
+    }
+
+    // padded to twice the record so the filtering does not wrap around
+    thePlan = FFT(2*numSteps);
+    int n = thePlan.getSize();
+
+    //
+    // target Fourier amplitude at the transform frequencies
+    //
+
+    amplitude.resize(n/2 + 1);
+    double df = 1.0/(n*dT);
+    for (int k=0; k<=n/2; k++)
+        amplitude[k] = this->getAmplitude(k*df);
+}
+
+double
+StochasticMotion::getAmplitude(double f) const
+{
+    const StochasticParameters &p = parameters;
+    if (f <= 0.0)
+        return 0.0;
+
+    double M0 = pow(10.0, 1.5*p.magnitude + 16.05);
+    double fc = 4.906e6 * p.shearVelocity * pow(p.stressDrop/M0, 1.0/3.0);
+
+    // radiation, partition onto two components (0.707), free surface (2), distances in km
+    double C = p.radiation * 0.707 * 2.0 / (4.0*PI*p.density*pow(p.shearVelocity,3)) * 1.0e-20;
+    double w = 2.0*PI*f;
+    double source = C*M0*w*w / (1.0 + (f/fc)*(f/fc));
+
+    double Q = p.Q0*pow(f, p.eta);
+    double path = exp(-PI*f*p.distance/(Q*p.shearVelocity)) / p.distance;
+    double site = p.siteAmplification*exp(-PI*p.kappa*f);
+
+    return source*path*site;
+}
+
+void
+StochasticMotion::generate(unsigned int seed, int realization, double *accel) const
+{
+    std::vector<std::complex<double> > work;
+    this->generate(seed, realization, accel, work);
+}
+
+void
+StochasticMotion::generate(unsigned int seed, int realization, double *accel,
+                           std::vector<std::complex<double> > &X) const
+{
+    int n = thePlan.getSize();
+    X.assign(n, std::complex<double>(0.0, 0.0));
+
+    //
+    // windowed white noise, the generator is seeded by (seed, realization)
+    //
+
+    std::seed_seq seq{seed, (unsigned int)realization};
+    std::mt19937 generator(seq);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    for (int j=0; j<numSteps; j++)
+        X[j] = std::complex<double>(window[j]*normal(generator), 0.0);
+
+    thePlan.forward(X.data());
+
+    //
+    // normalise the noise spectrum to unit mean square amplitude and shape it to the target,
+    // acceleration = inverse DFT / dT for amplitudes of the continuous transform
+    //
+
+    double sumSq = 0.0;
+    for (int k=0; k<=n/2; k++)
+        sumSq += std::norm(X[k]);
+    double scale = 1.0 / (sqrt(sumSq/(n/2 + 1)) * dT * GRAVITY_CM);
+
+    const double *A = amplitude.data();
+    for (int k=0; k<=n/2; k++)
+        X[k] *= A[k]*scale;
+    for (int k=n/2+1; k<n; k++)
+        X[k] *= A[n-k]*scale;
+
+    thePlan.inverse(X.data());
+
+    for (int j=0; j<numSteps; j++)
+        accel[j] = X[j].real();
+}
+
+void
+StochasticMotion::generate(unsigned int seed, int first, int count,
+                           std::vector<std::vector<double> > &records, int numThreads) const
+{
+    records.resize(count);
+    for (int i=0; i<count; i++)
+        records[i].resize(numSteps);
+
+    numThreads = std::max(1, std::min(numThreads, count));
+    std::atomic<int> next(0);
+
+    auto worker = [&]() {
+        std::vector<std::complex<double> > work;
+        int i;
+        while ((i = next++) < count)
+            this->generate(seed, first + i, records[i].data(), work);
+    };
+
+    std::vector<std::thread> threads;
+    for (int t=1; t<numThreads; t++)
+        threads.push_back(std::thread(worker));
+    worker();
+    for (unsigned int t=0; t<threads.size(); t++)
+        threads[t].join();
+}
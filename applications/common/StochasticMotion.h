@@ -0,0 +1,62 @@
+#ifndef STOCHASTIC_MOTION_H
+#define STOCHASTIC_MOTION_H
+
+#include <vector>
+#include <FFT.h>
+
+//The StochasticMotion class generates acceleration records with the stochastic point source
+//method (Boore 2003): windowed Gaussian white noise is given the Fourier amplitude spectrum
+//of a Brune source, with geometric spreading, anelastic attenuation and kappa. Everything
+//that does not depend on the noise (FFT plan, window, target amplitude spectrum) is set up
+//once in the constructor and shared by all realizations.
+
+struct StochasticParameters
+{
+    double magnitude = 6.5;
+    double distance = 20.0;         // hypocentral distance, km
+    double stressDrop = 100.0;      // bars
+    double kappa = 0.04;            // s
+    double Q0 = 180.0;              // Q(f) = Q0 f^eta
+    double eta = 0.45;
+    double density = 2.8;           // g/cm^3
+    double shearVelocity = 3.5;     // km/s
+    double radiation = 0.55;        // average radiation pattern
+    double siteAmplification = 1.0; // frequency independent site factor
+    double dT = 0.01;               // s
+};
+
+class StochasticMotion
+{
+public:
+    StochasticMotion(const StochasticParameters &parameters);
+
+    int getNumSteps(void) const {return numSteps;}
+    double getTimeStep(void) const {return dT;}
+    double getDuration(void) const {return duration;}
+
+    //This method returns the Fourier amplitude of acceleration (cm/s) at frequency f
+    double getAmplitude(double f) const;
+
+    //This method generates one realization (acceleration in g), realization i of a seed is
+    //always the same motion whichever batch or thread it is generated in
+    void generate(unsigned int seed, int realization, double *accel) const;
+
+    //This method generates realizations [first, first+count) into records[count][numSteps]
+    void generate(unsigned int seed, int first, int count,
+                  std::vector<std::vector<double> > &records, int numThreads) const;
+
+private:
+    void generate(unsigned int seed, int realization, double *accel,
+                  std::vector<std::complex<double> > &work) const;
+
+    StochasticParameters parameters;
+    double dT;
+    double duration;    // source + path duration, s
+    int numSteps;       // length of the window
+    FFT thePlan;        // transform length, numSteps padded to a power of two
+
+    std::vector<double> window;     // Saragoni-Hart shape, numSteps
+    std::vector<double> amplitude;  // target amplitude at the FFT frequencies, n/2+1
+};
+
+#endif
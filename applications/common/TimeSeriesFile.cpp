@@ -0,0 +1,246 @@
+#include <TimeSeriesFile.h>
+#include <Units.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define SERIES_MAGIC "GMTTSER1"
+#define SERIES_HEADER_SIZE 64
+
+struct SeriesHeader
+{
+    char magic[8];
+    uint32_t headerSize;
+    uint32_t reserved;
+    double dT;
+    int64_t numSteps;
+    char units[16];
+    char reserved2[16];
+};
+
+static bool
+isLittleEndian(void)
+{
+    uint16_t one = 1;
+    return *((const unsigned char *)&one) == 1;
+}
+
+static void
+swapBytes(void *value, int size)
+{
+    unsigned char *bytes = (unsigned char *)value;
+    for (int i=0; i<size/2; i++) {
+        unsigned char b = bytes[i];
+        bytes[i] = bytes[size-1-i];
+        bytes[size-1-i] = b;
+    }
+}
+
+TimeSeriesFile::TimeSeriesFile()
+    :dT(0.0), numSteps(0), data(0), mapping(0), mappingSize(0)
+{
+
+}
+
+TimeSeriesFile::~TimeSeriesFile()
+{
+    this->close();
+}
+
+void
+TimeSeriesFile::close(void)
+{
+#ifndef _WIN32
+    if (mapping != 0)
+        munmap(mapping, mappingSize);
+#endif
+    mapping = 0;
+    mappingSize = 0;
+    copy.clear();
+    data = 0;
+    numSteps = 0;
+    dT = 0.0;
+    units.clear();
+}
+
+int
+TimeSeriesFile::open(const char *filename)
+{
+    this->close();
+
+    FILE *fp = fopen(filename, "rb");
+    if (fp == NULL) {
+        std::cerr << "TimeSeriesFile - could not open " << filename << "\n";
+        return -1;
+    }
+
+    SeriesHeader header;
+    if (fread(&header, sizeof(SeriesHeader), 1, fp) != 1 || memcmp(header.magic, SERIES_MAGIC, 8) != 0) {
+        std::cerr << "TimeSeriesFile - " << filename << " is not a time series file\n";
+        fclose(fp);
+        return -1;
+    }
+
+    bool swap = !isLittleEndian();
+    if (swap) {
+        swapBytes(&header.headerSize, 4);
+        swapBytes(&header.dT, 8);
+        swapBytes(&header.numSteps, 8);
+    }
+
+    // a header that is too short or leaves the samples unaligned, or a negative count, is not ours
+    if (header.numSteps < 0 || header.numSteps > INT_MAX ||
+        header.headerSize < sizeof(SeriesHeader) || header.headerSize % 8 != 0) {
+        std::cerr << "TimeSeriesFile - " << filename << " has an invalid header\n";
+        fclose(fp);
+        return -1;
+    }
+
+    dT = header.dT;
+    numSteps = (int)header.numSteps;
+    units.assign(header.units, strnlen(header.units, 16));
+    size_t offset = header.headerSize;
+
+#ifndef _WIN32
+    if (swap == false) {
+        fclose(fp);
+        int fd = ::open(filename, O_RDONLY);
+        struct stat info;
+        if (fd >= 0 && fstat(fd, &info) == 0 && (size_t)info.st_size >= offset + numSteps*sizeof(double)) {
+            mappingSize = info.st_size;
+            mapping = mmap(0, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                mapping = 0;
+                std::cerr << "TimeSeriesFile - could not map " << filename << "\n";
+                this->close();
+                return -1;
+            }
+            data = (const double *)((const char *)mapping + offset);
+            return numSteps;
+        }
+        if (fd >= 0)
+            ::close(fd);
+        std::cerr << "TimeSeriesFile - " << filename << " is truncated\n";
+        this->close();
+        return -1;
+    }
+#endif
+
+    //
+    // no mapping: read the samples into memory
+    //
+
+    copy.resize(numSteps);
+    if (fseek(fp, offset, SEEK_SET) != 0 || fread(copy.data(), sizeof(double), numSteps, fp) != (size_t)numSteps) {
+        std::cerr << "TimeSeriesFile - " << filename << " is truncated\n";
+        fclose(fp);
+        this->close();
+        return -1;
+    }
+    fclose(fp);
+
+    if (swap)
+        for (int i=0; i<numSteps; i++)
+            swapBytes(&copy[i], 8);
+
+    data = copy.data();
+    return numSteps;
+}
+
+int
+TimeSeriesFile::write(const char *filename, double dT, const double *data, int numSteps, const char *units)
+{
+    SeriesHeader header;
+    memset(&header, 0, sizeof(SeriesHeader));
+    memcpy(header.magic, SERIES_MAGIC, 8);
+    header.headerSize = SERIES_HEADER_SIZE;
+    header.dT = dT;
+    header.numSteps = numSteps;
+    if (units != 0)
+        strncpy(header.units, units, 15);
+
+    bool swap = !isLittleEndian();
+    if (swap) {
+        swapBytes(&header.headerSize, 4);
+        swapBytes(&header.dT, 8);
+        swapBytes(&header.numSteps, 8);
+    }
+
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        std::cerr << "TimeSeriesFile - could not create " << filename << "\n";
+        return -1;
+    }
+
+    bool ok = (fwrite(&header, sizeof(SeriesHeader), 1, fp) == 1);
+    if (swap == false) {
+        ok = ok && (fwrite(data, sizeof(double), numSteps, fp) == (size_t)numSteps);
+    } else {
+        for (int i=0; i<numSteps && ok; i++) {
+            double value = data[i];
+            swapBytes(&value, 8);
+            ok = (fwrite(&value, sizeof(double), 1, fp) == 1);
+        }
+    }
+    fclose(fp);
+
+    if (ok == false) {
+        std::cerr << "TimeSeriesFile - could not write " << filename << "\n";
+        return -1;
+    }
+    return numSteps;
+}
+
+bool
+TimeSeriesFile::hasUnits(const char *lengthUnit, const char *timeUnit) const
+{
+    if (units.size() == 0)
+        return true;
+
+    bool fileGravity;
+    Units::UnitSystem fileUnits;
+    if (Units::ParseAccelerationUnit(units.c_str(), fileGravity, fileUnits) == false)
+        return false;
+
+    // the event motion is in g unless it gives units that are known
+    bool eventGravity = true;
+    Units::UnitSystem eventUnits;
+    if (lengthUnit != NULL && lengthUnit[0] != 0) {
+        eventUnits.lengthUnit = Units::ParseLengthUnit(lengthUnit);
+        eventUnits.timeUnit = (timeUnit != NULL && timeUnit[0] != 0) ? Units::ParseTimeUnit(timeUnit) : Units::TimeUnit::Second;
+        eventGravity = (eventUnits.lengthUnit == Units::LengthUnit::Unknown ||
+                        eventUnits.timeUnit == Units::TimeUnit::Unknown);
+    }
+
+    if (fileGravity == true || eventGravity == true)
+        return fileGravity == eventGravity;
+    return (fileUnits.lengthUnit == eventUnits.lengthUnit &&
+            fileUnits.timeUnit == eventUnits.timeUnit);
+}
+
+std::string
+TimeSeriesFile::resolvePath(const char *dataFile, const char *jsonFilename)
+{
+    std::string path(dataFile);
+    bool absolute = (path.size() > 0 && (path[0] == '/' || path[0] == '\\')) ||
+                    (path.size() > 1 && path[1] == ':');
+    if (absolute || jsonFilename == 0)
+        return path;
+
+    std::string jsonPath(jsonFilename);
+    size_t slash = jsonPath.find_last_of("/\\");
+    if (slash == std::string::npos)
+        return path;
+    return jsonPath.substr(0, slash+1) + path;
+}
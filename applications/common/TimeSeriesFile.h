@@ -0,0 +1,59 @@
+#ifndef TIME_SERIES_FILE_H
+#define TIME_SERIES_FILE_H
+
+#include <vector>
+#include <string>
+
+//The TimeSeriesFile class reads and writes the binary sidecar of a timeSeries entry, referenced
+//from the EVENT json by "dataFile" in place of a "data" array. The file is a 64 byte header
+//followed by the samples as little endian float64:
+//
+//   char[8]  magic "GMTTSER1"
+//   uint32   header size (64)
+//   uint32   reserved
+//   float64  dT
+//   int64    numSteps
+//   char[16] units (e.g. "g", "m/s^2"), zero padded
+//   char[16] reserved
+//
+//On open the file is memory mapped where possible (read into memory on Windows or when the
+//host is big endian), so the samples are used in place without any parsing.
+class TimeSeriesFile
+{
+public:
+    TimeSeriesFile();
+    ~TimeSeriesFile();
+
+    int open(const char *filename);
+    void close(void);
+
+    double getTimeStep(void) const {return dT;}
+    int getNumSteps(void) const {return numSteps;}
+    const std::string &getUnits(void) const {return units;}
+    const double *getData(void) const {return data;}
+
+    //This method returns true if the file is in the acceleration units of an event with the given
+    //"units" (g if it has none), a file without units is taken to be in those of its event
+    bool hasUnits(const char *lengthUnit, const char *timeUnit) const;
+
+    static int write(const char *filename, double dT, const double *data, int numSteps, const char *units);
+
+    //This method returns the path of a dataFile entry, relative paths are taken relative to
+    //the directory of the json file referencing it
+    static std::string resolvePath(const char *dataFile, const char *jsonFilename);
+
+private:
+    TimeSeriesFile(const TimeSeriesFile &);
+    TimeSeriesFile &operator=(const TimeSeriesFile &);
+
+    double dT;
+    int numSteps;
+    std::string units;
+    const double *data;
+
+    void *mapping;                // start of the mapped file, null if copied
+    size_t mappingSize;
+    std::vector<double> copy;
+};
+
+#endif
@@ -173,6 +173,31 @@ TimeUnit ParseTimeUnit(const char* timeUnit)
     return TimeUnit::Unknown;
 }
 
+bool ParseAccelerationUnit(const char* accelerationUnit, bool& isGravity, UnitSystem& unitSystem)
+{
+    std::string units(accelerationUnit);
+    isGravity = (units == "g" || units == "G");
+    if (isGravity)
+        return true;
+
+    size_t slash = units.find('/');
+    if (slash == std::string::npos)
+        return false;
+    std::string length = units.substr(0, slash);
+    std::string time = units.substr(slash+1);
+    if (time.size() > 2 && time.compare(time.size()-2, 2, "^2") == 0)
+        time.resize(time.size()-2);
+    else if (time.size() > 1 && time.compare(time.size()-1, 1, "2") == 0)
+        time.resize(time.size()-1);
+    else
+        return false;
+
+    unitSystem.lengthUnit = ParseLengthUnit(length.c_str());
+    unitSystem.timeUnit = ParseTimeUnit(time.c_str());
+    return (unitSystem.lengthUnit != LengthUnit::Unknown &&
+            unitSystem.timeUnit != TimeUnit::Unknown);
+}
+
 double GetGravity(UnitSystem &unitSystem)
 {
     double gravity = 9.80665; //in SI Units (m/sec^2)
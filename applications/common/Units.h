@@ -21,6 +21,9 @@ LengthUnit ParseLengthUnit(const char* lengthUnitString);
 //This method parses a string int a time unit enumerator
 TimeUnit ParseTimeUnit(const char* timeUnitString);
 
+//This method parses an acceleration unit string, "g" or length/time^2 (e.g. "m/s^2", "in/sec2")
+bool ParseAccelerationUnit(const char* accelerationUnitString, bool& isGravity, UnitSystem& unitSystem);
+
 //This method finds the convertion factor from one length unit to another
 double GetLengthFactor(UnitSystem& fromUnit, UnitSystem& toUnit);
 
@@ -0,0 +1,64 @@
+#include <WorkerSocket.h>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+#ifndef _WIN32
+
+static int
+checkSocketDirectory(const std::string &directory)
+{
+    struct stat status;
+    if (lstat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode)) {
+      std::cerr << "ERROR - socket directory " << directory << " does not exist\n";
+      return -1;
+    }
+    if (status.st_uid != getuid() || (status.st_mode & 077) != 0) {
+      std::cerr << "ERROR - socket directory " << directory << " must belong to the user with mode 0700\n";
+      return -1;
+    }
+    return 0;
+}
+
+int
+getWorkerSocketPath(const char *socketName, std::string &socketPath)
+{
+    std::string name(socketName);
+    size_t slash = name.find_last_of('/');
+    if (slash != std::string::npos) {
+      socketPath = name;
+      return checkSocketDirectory(slash == 0 ? std::string("/") : name.substr(0, slash));
+    }
+
+    std::string directory;
+    const char *runtimeDirectory = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDirectory != NULL && runtimeDirectory[0] != 0)
+      directory = runtimeDirectory;
+    else {
+      directory = "/tmp/ExtractPGA-" + std::to_string(getuid());
+      if (mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST) {
+	std::cerr << "ERROR - could not create " << directory << ": " << strerror(errno) << "\n";
+	return -1;
+      }
+    }
+
+    socketPath = directory + "/" + name;
+    return checkSocketDirectory(directory);
+}
+
+#else
+
+int
+getWorkerSocketPath(const char *socketName, std::string &socketPath)
+{
+    std::cerr << "ERROR - worker sockets are not available on Windows\n";
+    return -1;
+}
+
+#endif
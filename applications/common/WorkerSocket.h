@@ -0,0 +1,15 @@
+#ifndef WORKER_SOCKET_H
+#define WORKER_SOCKET_H
+
+#include <string>
+
+//The unix socket of the persistent ExtractPGA worker, shared by the worker and its client: a
+//socket name without a directory is placed in $XDG_RUNTIME_DIR, or in /tmp/ExtractPGA-<uid>
+//(created with mode 0700) if that is not set. The directory must belong to the user and be
+//closed to group and others, so no one else can reach the socket or put one in its place.
+
+//This method returns in socketPath where the socket of a name is, 0 if ok, -1 if its directory
+//can not be used
+int getWorkerSocketPath(const char *socketName, std::string &socketPath);
+
+#endif
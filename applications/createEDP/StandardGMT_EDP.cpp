@@ -3,23 +3,45 @@
 #include <string.h>
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <iostream>
 #include <cmath>
 using namespace std;
 
 #include <jansson.h>  // for Json
+#include <EventReader.h>
+#include <EDPCatalog.h>
+#include <EDPWriter.h>
+
+//
+// StandardGMT_EDP: writes the EDP template for the events of an EVENT file, the responses of the
+// EDPCatalog (the PGA of every dof unless the BIM "IntensityMeasures" or the command line asks
+// for more) for each dof, in one pass over the event structure
+//
+//   StandardGMT_EDP --filenameBIM BIM.json --filenameEVENT EVENT.json --filenameEDP EDP.json
+//                   [--measures PGA,SA,PGV --periods 0.2,0.5,1.0 --getRV]
+//
+// the simulation application (ExtractPGA, ExtractIMs) is to be given the same request
+//
 
 int main(int argc, char **argv)
 {
 
+  char *filenameBIM = NULL;
   char *filenameEVENT = NULL;
   char *filenameEDP = NULL;
+  char *measureList = NULL;
+  char *periodList = NULL;
   bool getRV = false;
 
   int arg = 1;
   while (arg < argc) {
-      if (strcmp(argv[arg], "--filenameEVENT") ==0) {
+      if (strcmp(argv[arg], "--filenameBIM") ==0) {
+	arg++;
+	filenameBIM = argv[arg];
+      }
+      else if (strcmp(argv[arg], "--filenameEVENT") ==0) {
 	arg++;
 	filenameEVENT = argv[arg];
       }
@@ -27,10 +49,18 @@ int main(int argc, char **argv)
 	arg++;
 	filenameEDP = argv[arg];
       }
+      else if (strcmp(argv[arg], "--measures") ==0) {
+	arg++;
+	measureList = argv[arg];
+      }
+      else if (strcmp(argv[arg], "--periods") ==0) {
+	arg++;
+	periodList = argv[arg];
+      }
       else if (strcmp(argv[arg], "--getRV") ==0) {
 	getRV = true;
       }
-      
+
       arg++;
     }
 
@@ -38,103 +68,63 @@ int main(int argc, char **argv)
     // if not all args present, exit with error
     //
 
-    if (filenameEVENT == 0) {
+    if (filenameEVENT == 0 || filenameEDP == 0) {
       std::cerr << "ERROR - missing input args\n";
       exit(-1);
     }
 
-    // create output JSON object
-    json_t *rootEDP = json_object();
-
-    // place an empty random variable field
-    json_t *rvArray=json_array();   
-    json_object_set(rootEDP,"RandomVariables",rvArray);
+    EDPCatalog theCatalog;
+    if (theCatalog.configure(filenameBIM, measureList, periodList) < 0)
+      exit(-1);
+    const vector<EDPCatalog::Entry> &entries = theCatalog.getEntries();
+    int numEntries = entries.size();
 
     //
-    // for each event we create the edp's
+    // for each event we create the edp's, the event structure is read with the data arrays skipped
     //
 
-    json_t *eventArray = json_array(); // for each analysis event
-
-    // load SAM and EVENT files
-    json_error_t error;
-
-    json_t *rootEVENT = json_load_file(filenameEVENT, 0, &error);
-    json_t *eventsArray = json_object_get(rootEVENT,"Events");  
-    
-    int index;
-    json_t *value;
-    
-    int numEDP = 0;
-    
-    json_array_foreach(eventsArray, index, value) {
-      
+    EDPWriter theWriter;
+
+    EventReader theReader(EventReader::SkipData);
+    int result = theReader.read(filenameEVENT, [&](EventRecord &theEvent) {
+
       // check earthquake
-      json_t *type = json_object_get(value,"type");  
-      const char *eventType = json_string_value(type);
-      
+      const char *eventType = theEvent.type.c_str();
+
       if (strcmp(eventType,"Seismic") != 0) {
-	json_object_clear(rootEVENT);
 	printf("WARNING event type %s not Seismic NO OUTPUT", eventType);
       }
-      
-      // add the EDP for the event
-      json_t *eventObj = json_object();
-      
-      json_t *name = json_object_get(value,"name"); 
-      const char *eventName = json_string_value(name);
-      json_object_set(eventObj,"name",json_string(eventName));
-
-      int numDOF = 0;
-      json_t *theDOFs = json_array();
-      int *tDOFs = 0;
-      json_t *patternArray = json_object_get(value,"pattern");
-      int numPattern = json_array_size(patternArray);
-      tDOFs = new int[numPattern];
-
-      if (numPattern != 0) {
-	for (int ii=0; ii<numPattern; ii++) {
-	  json_t *thePattern = json_array_get(patternArray, ii);
-	  json_t *theDof = json_object_get(thePattern, "dof");
-	  tDOFs[ii] = json_integer_value(theDof);
-	  if (theDof != 0) {
-	    json_array_append(theDOFs, theDof);
-	    numDOF++;
-	  } else {
-	    printf("ERROR no dof with Seismic event pattern %d", ii);
-	    exit(-1);
-	  }
+
+      int numPattern = theEvent.pattern.size();
+      if (numPattern == 0) {
+	std::cerr << "ERROR no patterns with Seismic event " << theEvent.name << "\n";
+	return false;
+      }
+
+      vector<int> dofs(numPattern);
+      for (int ii=0; ii<numPattern; ii++) {
+	dofs[ii] = theEvent.pattern[ii].dof;
+	if (dofs[ii] == 0) {
+	  std::cerr << "ERROR no dof with Seismic event pattern " << ii << "\n";
+	  return false;
 	}
-      } else {
-	printf("ERROR no patterns with Seismic event");
-	exit(-1);
       }
-      
-      //    json_dump_file(eventObj,"TEST",0);
-
-      json_t *responsesArray = json_array(); // for each analysis event
-      
-      // max ground acceleration
-      json_t *responseA = json_object();
-      json_object_set(responseA,"type",json_string("PGA"));      
-      json_object_set(responseA,"dofs",theDOFs);
-      json_t *dataArrayA = json_array(); 
-      json_object_set(responseA,"scalar_data",dataArrayA);
-      json_array_append(responsesArray,responseA);
-      numEDP += numDOF;
-
-      json_object_set(eventObj,"responses",responsesArray);
-      
-      json_array_append(eventArray,eventObj);
-
-      if (tDOFs != 0)
-	delete [] tDOFs;
-    }
 
-    json_object_set(rootEDP,"total_number_edp",json_integer(numEDP));  
-    json_object_set(rootEDP,"EngineeringDemandParameters",eventArray);  
+      // add the EDP for the event, the scalar data left empty
+      theWriter.beginEvent(theEvent.name.c_str());
+      for (int i=0; i<numEntries; i++)
+	theWriter.addResponse(entries[i].type.c_str(), dofs.data(), 0, numPattern,
+			      (entries[i].measure == EDPCatalog::SA) ? entries[i].period : 0.0);
+      theWriter.endEvent();
+
+      return true;
+    });
 
-    json_dump_file(rootEDP,filenameEDP,0);   
+    if (result < 0)
+      exit(-1);
+
+    if (theWriter.writeEDP(filenameEDP) < 0)
+      exit(-1);
 
     return 0;
 }
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+#include <jansson.h>  // for Json
+#include <EventSeries.h>
+#include <EventUnits.h>
+#include <SiteResponse.h>
+
+//
+// EquivalentLinear: carries the rock outcrop motions of every Seismic event in an EVENT file to the
+// ground surface of a 1D soil column. The profile is read from the "SiteResponse" object of the BIM
+// (so layer properties may be random variables) or from a separate profile file:
+//
+//   {"layers":[{"thickness":3, "Vs":180, "density":1900, "referenceStrain":0.001, "curvature":1.0,
+//               "minDamping":0.01, "maxDamping":0.2}, ..],
+//    "rock":{"Vs":760, "density":2200, "damping":0.01}, "gravity":9.81}
+//
+// layers are listed from the surface down. The motions are converted from the event "units" (g if
+// the event has none) to g and back, "gravity" is g in the units of the profile (9.81 for m)
+//
+//   EquivalentLinear --filenameEVENT EVENT.json (--filenameBIM BIM.json | --filenameProfile profile.json)
+//                    [--filenameOut EVENT.json --maxIterations 15 --tolerance 0.01]
+//
+
+static double
+getNumber(json_t *obj, const char *key, double defaultValue)
+{
+  json_t *value = json_object_get(obj, key);
+  if (value == NULL || !json_is_number(value))
+    return defaultValue;
+  return json_number_value(value);
+}
+
+int main(int argc, char **argv)
+{
+  char *filenameEVENT = NULL;
+  char *filenameBIM = NULL;
+  char *filenameProfile = NULL;
+  char *filenameOut = NULL;
+  bool getRV = false;
+
+  SiteResponseOptions options;
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--filenameEVENT") ==0) {
+      arg++;
+      filenameEVENT = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameBIM") ==0) {
+      arg++;
+      filenameBIM = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameProfile") ==0) {
+      arg++;
+      filenameProfile = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameOut") ==0) {
+      arg++;
+      filenameOut = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--maxIterations") ==0) {
+      arg++;
+      options.maxIterations = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--tolerance") ==0) {
+      arg++;
+      options.tolerance = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--getRV") ==0) {
+      getRV = true;
+    }
+
+    arg++;
+  }
+
+  if (filenameEVENT == 0 || (filenameBIM == 0 && filenameProfile == 0)) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  // the event structure is unchanged by the site response
+  if (getRV == true)
+    return 0;
+
+  if (filenameOut == 0)
+    filenameOut = filenameEVENT;
+
+  //
+  // soil column
+  //
+
+  json_error_t error;
+  const char *filenameSite = (filenameProfile != 0) ? filenameProfile : filenameBIM;
+  json_t *rootSite = json_load_file(filenameSite, 0, &error);
+  if (rootSite == NULL) {
+    std::cerr << "ERROR - could not parse " << filenameSite << ": " << error.text << "\n";
+    exit(-1);
+  }
+  json_t *profile = (filenameProfile != 0) ? rootSite : json_object_get(rootSite,"SiteResponse");
+
+  vector<SoilLayer> layers;
+  json_t *layersArray = json_object_get(profile,"layers");
+  int index;
+  json_t *value;
+  json_array_foreach(layersArray, index, value) {
+    SoilLayer theLayer;
+    theLayer.thickness = getNumber(value, "thickness", 0.0);
+    theLayer.shearVelocity = getNumber(value, "Vs", 0.0);
+    theLayer.density = getNumber(value, "density", 0.0);
+    theLayer.referenceStrain = getNumber(value, "referenceStrain", theLayer.referenceStrain);
+    theLayer.curvature = getNumber(value, "curvature", theLayer.curvature);
+    theLayer.minDamping = getNumber(value, "minDamping", theLayer.minDamping);
+    theLayer.maxDamping = getNumber(value, "maxDamping", theLayer.maxDamping);
+
+    if (theLayer.thickness <= 0.0 || theLayer.shearVelocity <= 0.0 || theLayer.density <= 0.0) {
+      std::cerr << "ERROR - layer " << index+1 << " needs thickness, Vs and density\n";
+      exit(-1);
+    }
+    layers.push_back(theLayer);
+  }
+
+  json_t *rock = json_object_get(profile,"rock");
+  double rockVs = getNumber(rock, "Vs", 760.0);
+  double rockDensity = getNumber(rock, "density", 2200.0);
+  double rockDamping = getNumber(rock, "damping", 0.01);
+  options.gravity = getNumber(profile, "gravity", options.gravity);
+  json_decref(rootSite);
+
+  if (layers.size() == 0) {
+    std::cerr << "ERROR - no soil layers in " << filenameSite << "\n";
+    exit(-1);
+  }
+
+  SiteResponse theSite(layers, rockVs, rockDensity, rockDamping);
+
+  //
+  // surface motion of each series, stored back relative to its factor
+  //
+
+  json_t *rootEVENT = json_load_file(filenameEVENT, 0, &error);
+  if (rootEVENT == NULL) {
+    std::cerr << "ERROR - could not parse " << filenameEVENT << ": " << error.text << "\n";
+    exit(-1);
+  }
+  json_t *eventsArray = json_object_get(rootEVENT,"Events");
+
+  json_array_foreach(eventsArray, index, value) {
+
+    const char *eventType = json_string_value(json_object_get(value,"type"));
+    if (eventType == NULL || strcmp(eventType,"Seismic") != 0) {
+      printf("WARNING event type %s not Seismic, site response not computed\n", (eventType != NULL) ? eventType : "(none)");
+      continue;
+    }
+
+    vector<EventSeries> theSeries;
+    if (readEventSeries(value, theSeries, filenameEVENT) < 0)
+      exit(-1);
+
+    // the site response is computed in g and seconds, the motions are written back in their units
+    EventRecord theEvent;
+    readEventUnits(value, theEvent);
+    Units::UnitSystem SIUnits;
+    SIUnits.lengthUnit = Units::LengthUnit::Meter;
+    SIUnits.timeUnit = Units::TimeUnit::Second;
+    double unitConversionFactor = getUnitConversionFactor(theEvent, 0);
+    double timeConversionFactor = getTimeConversionFactor(theEvent, SIUnits);
+
+    for (unsigned int i=0; i<theSeries.size(); i++) {
+
+      EventSeries &theRecord = theSeries[i];
+      int numSteps = theRecord.data.size();
+      if (numSteps == 0 || theRecord.factor == 0.0)
+        continue;
+
+      double scale = theRecord.factor * unitConversionFactor;
+      vector<double> accel(numSteps);
+      for (int n=0; n<numSteps; n++)
+        accel[n] = theRecord.data[n] * scale;
+
+      vector<double> surface(numSteps);
+      int numIter = theSite.compute(accel.data(), numSteps, theRecord.dT * timeConversionFactor,
+                                    surface.data(), options);
+      if (numIter < 0) {
+        std::cerr << "ERROR - site response of " << theRecord.name << " did not converge in "
+                  << options.maxIterations << " iterations\n";
+        exit(-1);
+      }
+
+      for (int n=0; n<numSteps; n++)
+        theRecord.data[n] = surface[n] / scale;
+
+      writeEventSeries(value, theRecord);
+    }
+  }
+
+  json_dump_file(rootEVENT,filenameOut,0);
+  json_decref(rootEVENT);
+
+  return 0;
+}
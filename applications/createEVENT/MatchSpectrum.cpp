@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+#include <jansson.h>  // for Json
+#include <EventSeries.h>
+#include <SpectralMatching.h>
+
+//
+// MatchSpectrum: modifies the "Value" time series of every Seismic event in an EVENT file
+// so that their response spectra match a target spectrum. The matched motions are written
+// back into the same timeSeries entries (existing "factor" entries are kept).
+//
+// the target file contains {"periods":[..], "spectrum":[..], "damping":0.05, "units":"g"}, the
+// spectrum is converted to the units of each event (g if it has none); with no "units" it is
+// taken to be in the units of the scaled motion (data * factor)
+//
+
+int main(int argc, char **argv)
+{
+  char *filenameEVENT = NULL;
+  char *filenameTarget = NULL;
+  char *filenameOut = NULL;
+  bool getRV = false;
+
+  SpectralMatchOptions options;
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--filenameEVENT") ==0) {
+      arg++;
+      filenameEVENT = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameTarget") ==0) {
+      arg++;
+      filenameTarget = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameOut") ==0) {
+      arg++;
+      filenameOut = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--tolerance") ==0) {
+      arg++;
+      options.tolerance = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--maxIterations") ==0) {
+      arg++;
+      options.maxIterations = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--getRV") ==0) {
+      getRV = true;
+    }
+
+    arg++;
+  }
+
+  //
+  // if not all args present, exit with error
+  //
+
+  if (filenameEVENT == 0 || filenameTarget == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  // no random variables introduced by matching
+  if (getRV == true)
+    return 0;
+
+  if (filenameOut == 0)
+    filenameOut = filenameEVENT;
+
+  vector<double> periods;
+  vector<double> target;
+  double dampingRatio;
+  string targetUnits;
+  if (readTargetSpectrum(filenameTarget, periods, target, dampingRatio, targetUnits) <= 0)
+    exit(-1);
+
+  json_error_t error;
+  json_t *rootEVENT = json_load_file(filenameEVENT, 0, &error);
+  if (rootEVENT == NULL) {
+    std::cerr << "ERROR - could not parse " << filenameEVENT << ": " << error.text << "\n";
+    exit(-1);
+  }
+  json_t *eventsArray = json_object_get(rootEVENT,"Events");
+
+  int index;
+  json_t *value;
+
+  json_array_foreach(eventsArray, index, value) {
+
+    const char *eventType = json_string_value(json_object_get(value,"type"));
+    if (eventType == NULL || strcmp(eventType,"Seismic") != 0) {
+      printf("WARNING event type %s not Seismic, not matched\n", (eventType != NULL) ? eventType : "(none)");
+      continue;
+    }
+
+    vector<EventSeries> theSeries;
+    if (readEventSeries(value, theSeries, filenameEVENT) < 0)
+      exit(-1);
+
+    // the target in the units of the event
+    double targetFactor = getAccelerationFactor(targetUnits, value);
+    if (targetFactor <= 0.0)
+      exit(-1);
+    vector<double> eventTarget(target);
+    for (unsigned int k=0; k<eventTarget.size(); k++)
+      eventTarget[k] *= targetFactor;
+
+    for (unsigned int i=0; i<theSeries.size(); i++) {
+
+      EventSeries &theRecord = theSeries[i];
+      int numSteps = theRecord.data.size();
+      if (numSteps == 0 || theRecord.factor == 0.0)
+        continue;
+
+      // match the scaled motion, store it back relative to the factor
+      vector<double> accel(numSteps);
+      for (int n=0; n<numSteps; n++)
+        accel[n] = theRecord.data[n] * theRecord.factor;
+
+      SpectralMatcher theMatcher(periods, eventTarget, dampingRatio, theRecord.dT, numSteps);
+      int numIter = theMatcher.match(accel, options);
+      if (numIter < 0)
+        exit(-1);
+
+      std::cerr << theRecord.name << ": " << numIter << " iterations, max misfit "
+                << theMatcher.getMisfit() << "\n";
+
+      for (int n=0; n<numSteps; n++)
+        theRecord.data[n] = accel[n] / theRecord.factor;
+
+      writeEventSeries(value, theRecord);
+    }
+  }
+
+  json_dump_file(rootEVENT,filenameOut,0);
+  json_decref(rootEVENT);
+
+  return 0;
+}
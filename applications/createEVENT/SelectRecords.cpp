@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cmath>
+#include <thread>
+using namespace std;
+
+#include <jansson.h>  // for Json
+#include <EventSeries.h>
+#include <RecordSelection.h>
+
+//
+// SelectRecords: record selection against a target spectrum from a local record library
+//
+//  1) build the spectral index of a library, the list file holds one event file per line
+//       SelectRecords --buildIndex library.txt --index library.idx
+//                     [--minPeriod 0.01 --maxPeriod 10 --numPeriods 100 --damping 0.05 --numThreads n]
+//
+//  2) select the N best optimally scaled records & write them as the events of an EVENT file
+//       SelectRecords --index library.idx --filenameTarget target.json --numRecords N
+//                     --filenameEVENT EVENT.json [--minScale 0.25 --maxScale 4]
+//
+
+int main(int argc, char **argv)
+{
+  char *filenameList = NULL;
+  char *filenameIndex = NULL;
+  char *filenameTarget = NULL;
+  char *filenameEVENT = NULL;
+  int numRecords = 10;
+  int numPeriods = 100;
+  double minPeriod = 0.01;
+  double maxPeriod = 10.0;
+  double dampingRatio = 0.05;
+  int numThreads = std::thread::hardware_concurrency();
+
+  SelectionOptions options;
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--buildIndex") ==0) {
+      arg++;
+      filenameList = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--index") ==0) {
+      arg++;
+      filenameIndex = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameTarget") ==0) {
+      arg++;
+      filenameTarget = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameEVENT") ==0) {
+      arg++;
+      filenameEVENT = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--numRecords") ==0) {
+      arg++;
+      numRecords = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--numPeriods") ==0) {
+      arg++;
+      numPeriods = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--minPeriod") ==0) {
+      arg++;
+      minPeriod = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--maxPeriod") ==0) {
+      arg++;
+      maxPeriod = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--damping") ==0) {
+      arg++;
+      dampingRatio = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--numThreads") ==0) {
+      arg++;
+      numThreads = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--minScale") ==0) {
+      arg++;
+      options.minScale = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--maxScale") ==0) {
+      arg++;
+      options.maxScale = atof(argv[arg]);
+    }
+
+    arg++;
+  }
+
+  if (filenameIndex == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  SpectralIndex theIndex;
+
+  //
+  // build mode
+  //
+
+  if (filenameList != 0) {
+
+    vector<string> eventFiles;
+    ifstream listFile(filenameList);
+    if (!listFile.is_open()) {
+      std::cerr << "ERROR - could not open " << filenameList << "\n";
+      exit(-1);
+    }
+    string line;
+    while (getline(listFile, line))
+      if (line.size() != 0)
+        eventFiles.push_back(line);
+    listFile.close();
+
+    if (numPeriods < 2 || minPeriod <= 0.0 || maxPeriod <= minPeriod) {
+      std::cerr << "ERROR - invalid period range\n";
+      exit(-1);
+    }
+    vector<double> periods(numPeriods);
+    for (int i=0; i<numPeriods; i++)
+      periods[i] = minPeriod * pow(maxPeriod/minPeriod, i/(numPeriods-1.0));
+
+    int numRows = theIndex.build(eventFiles, periods, dampingRatio, numThreads);
+    std::cerr << "indexed " << numRows << " records from " << eventFiles.size() << " files\n";
+
+    return theIndex.save(filenameIndex);
+  }
+
+  //
+  // selection mode
+  //
+
+  if (filenameTarget == 0 || filenameEVENT == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  if (theIndex.load(filenameIndex) < 0)
+    exit(-1);
+
+  vector<double> targetPeriods;
+  vector<double> targetSa;
+  double targetDamping;
+  string targetUnits;
+  if (readTargetSpectrum(filenameTarget, targetPeriods, targetSa, targetDamping, targetUnits) <= 0)
+    exit(-1);
+
+  // the index spectra are in g, as is a target with no units
+  double targetFactor = getAccelerationFactor(targetUnits, NULL);
+  if (targetFactor <= 0.0)
+    exit(-1);
+  for (unsigned int i=0; i<targetSa.size(); i++)
+    targetSa[i] *= targetFactor;
+  if (fabs(targetDamping - theIndex.getDampingRatio()) > 1.0e-6)
+    std::cerr << "WARNING target damping " << targetDamping << " differs from index damping "
+              << theIndex.getDampingRatio() << "\n";
+
+  vector<SelectedRecord> selection;
+  vector<double> weights;
+  if (theIndex.select(targetPeriods, targetSa, weights, numRecords, options, selection) <= 0) {
+    std::cerr << "ERROR - no records selected\n";
+    exit(-1);
+  }
+
+  //
+  // write the selected records, scaled through the timeSeries factor and in their own units, as
+  // the events of the EVENT file
+  //
+
+  json_t *rootEVENT = json_object();
+  json_t *eventsArray = json_array();
+
+  for (unsigned int i=0; i<selection.size(); i++) {
+    const string &file = theIndex.getFile(selection[i].row);
+    const string &seriesName = theIndex.getSeriesName(selection[i].row);
+    int eventIndex = theIndex.getEventIndex(selection[i].row);
+
+    json_error_t error;
+    json_t *rootRecord = json_load_file(file.c_str(), 0, &error);
+    if (rootRecord == NULL) {
+      std::cerr << "ERROR - could not parse " << file << "\n";
+      exit(-1);
+    }
+
+    // the series of the event it was indexed from, a name may be used by several events
+    vector<EventSeries> theSeries;
+    vector<EventSeries> theRecord;
+    json_t *recordEvent = json_array_get(json_object_get(rootRecord,"Events"), eventIndex);
+    if (recordEvent != NULL && readEventSeries(recordEvent, theSeries, file.c_str()) > 0) {
+      for (unsigned int s=0; s<theSeries.size() && theRecord.size() == 0; s++)
+        if (theSeries[s].name == seriesName)
+          theRecord.push_back(theSeries[s]);
+    }
+    json_t *recordUnits = json_incref(json_object_get(recordEvent,"units"));
+    json_decref(rootRecord);
+
+    if (theRecord.size() == 0) {
+      std::cerr << "ERROR - " << seriesName << " no longer in event " << eventIndex << " of " << file << "\n";
+      exit(-1);
+    }
+
+    // applied to the dof of the pattern it came from
+    theRecord[0].factor *= selection[i].scale;
+    string eventName = file + ":" + std::to_string(eventIndex) + ":" + seriesName;
+    int dof = theIndex.getDof(selection[i].row);
+    vector<int> dofs(1, (dof != 0) ? dof : 1);
+    json_t *event = createSeismicEvent(eventName.c_str(), theRecord, dofs);
+    if (recordUnits != NULL)
+      json_object_set_new(event,"units",recordUnits);
+    json_array_append_new(eventsArray, event);
+
+    std::cerr << eventName << " scale " << selection[i].scale << " misfit " << selection[i].misfit << "\n";
+  }
+
+  json_object_set_new(rootEVENT,"Events",eventsArray);
+  json_dump_file(rootEVENT,filenameEVENT,0);
+  json_decref(rootEVENT);
+
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <thread>
+using namespace std;
+
+#include <jansson.h>  // for Json
+#include <EventSeries.h>
+#include <StochasticMotion.h>
+#include <TimeSeriesFile.h>
+
+//
+// StochasticGM: synthetic records from the stochastic point source method. The model parameters
+// are read from the first event of the BIM file, e.g. {"type":"StochasticMotion", "magnitude":6.5,
+// "distance":20, "stressDrop":100, "kappa":0.04, "seed":1, "numRealizations":1}; any of them may be
+// set by a random variable so a new record is generated for every sample, the workflow writing its
+// value into the BIM of the sample. A parameter that is not a number (e.g. a random variable name
+// left unresolved) is an error, the app has no random variables of its own. Each realization is
+// written as a Seismic event (acceleration in g) of the EVENT file, with --binary the samples go to
+// binary sidecar files next to the EVENT file referenced by "dataFile" (see TimeSeriesFile)
+//
+//   StochasticGM --filenameBIM BIM.json --filenameEVENT EVENT.json [--getRV]
+//                [--seed s --numRealizations n --numThreads t --binary]
+//
+
+static int
+readParameter(json_t *event, const char *key, double &value)
+{
+  json_t *obj = json_object_get(event, key);
+  if (obj == NULL)
+    return 0;
+  if (!json_is_number(obj)) {
+    const char *name = json_string_value(obj);
+    std::cerr << "ERROR - stochastic motion parameter " << key << " must be a number";
+    if (name != NULL)
+      std::cerr << ", the random variable " << name << " has no value";
+    std::cerr << "\n";
+    return -1;
+  }
+  value = json_number_value(obj);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  char *filenameBIM = NULL;
+  char *filenameEVENT = NULL;
+  bool getRV = false;
+  bool binary = false;
+  int seed = -1;
+  int numRealizations = 0;
+  int numThreads = std::thread::hardware_concurrency();
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--filenameBIM") ==0) {
+      arg++;
+      filenameBIM = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameEVENT") ==0) {
+      arg++;
+      filenameEVENT = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--seed") ==0) {
+      arg++;
+      seed = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--numRealizations") ==0) {
+      arg++;
+      numRealizations = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--numThreads") ==0) {
+      arg++;
+      numThreads = atoi(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--binary") ==0) {
+      binary = true;
+    }
+    else if (strcmp(argv[arg], "--getRV") ==0) {
+      getRV = true;
+    }
+
+    arg++;
+  }
+
+  if (filenameBIM == 0 || filenameEVENT == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  //
+  // model parameters from the BIM event
+  //
+
+  json_error_t error;
+  json_t *rootBIM = json_load_file(filenameBIM, 0, &error);
+  if (rootBIM == NULL) {
+    std::cerr << "ERROR - could not parse " << filenameBIM << ": " << error.text << "\n";
+    exit(-1);
+  }
+
+  json_t *theEvent = json_array_get(json_object_get(rootBIM,"Events"), 0);
+  if (theEvent == NULL) {
+    std::cerr << "ERROR - no Events in " << filenameBIM << "\n";
+    exit(-1);
+  }
+
+  StochasticParameters parameters;
+  int result = 0;
+  result += readParameter(theEvent, "magnitude", parameters.magnitude);
+  result += readParameter(theEvent, "distance", parameters.distance);
+  result += readParameter(theEvent, "stressDrop", parameters.stressDrop);
+  result += readParameter(theEvent, "kappa", parameters.kappa);
+  result += readParameter(theEvent, "Q0", parameters.Q0);
+  result += readParameter(theEvent, "eta", parameters.eta);
+  result += readParameter(theEvent, "shearVelocity", parameters.shearVelocity);
+  result += readParameter(theEvent, "density", parameters.density);
+  result += readParameter(theEvent, "siteAmplification", parameters.siteAmplification);
+  result += readParameter(theEvent, "dT", parameters.dT);
+
+  double value = 1.0;
+  if (seed < 0) {
+    result += readParameter(theEvent, "seed", value);
+    seed = (int)value;
+  }
+  if (numRealizations <= 0) {
+    value = 1.0;
+    result += readParameter(theEvent, "numRealizations", value);
+    numRealizations = (int)value;
+  }
+  json_decref(rootBIM);
+
+  if (result < 0)
+    exit(-1);
+
+  if (numRealizations <= 0 || parameters.distance <= 0.0 || parameters.dT <= 0.0) {
+    std::cerr << "ERROR - invalid stochastic motion parameters\n";
+    exit(-1);
+  }
+
+  //
+  // generate the batch (structure only when asked for the random variables)
+  //
+
+  StochasticMotion theModel(parameters);
+
+  vector<vector<double> > records;
+  if (getRV == false)
+    theModel.generate(seed, 0, numRealizations, records, numThreads);
+
+  json_t *rootEVENT = json_object();
+  json_t *eventsArray = json_array();
+  // no random variables of its own, those setting the parameters are the workflow's
+  json_object_set_new(rootEVENT,"RandomVariables",json_array());
+
+  vector<int> dofs(1, 1);
+  for (int i=0; i<numRealizations; i++) {
+    vector<EventSeries> theSeries(1);
+    theSeries[0].name = "accel-" + to_string(i+1);
+    theSeries[0].dT = parameters.dT;
+    if (getRV == false && binary == false)
+      theSeries[0].data.swap(records[i]);
+
+    string eventName = "stochastic-" + to_string(i+1);
+    json_t *event = createSeismicEvent(eventName.c_str(), theSeries, dofs);
+    json_object_set_new(event,"numSteps",json_integer(theModel.getNumSteps()));
+
+    if (binary == true) {
+      string dataFile = theSeries[0].name + ".bin";
+      if (getRV == false) {
+        string path = TimeSeriesFile::resolvePath(dataFile.c_str(), filenameEVENT);
+        if (TimeSeriesFile::write(path.c_str(), parameters.dT, records[i].data(), records[i].size(), "g") < 0)
+          exit(-1);
+      }
+      json_t *timeSeriesObj = json_array_get(json_object_get(event,"timeSeries"), 0);
+      json_object_del(timeSeriesObj,"data");
+      json_object_set_new(timeSeriesObj,"dataFile",json_string(dataFile.c_str()));
+    }
+    json_array_append_new(eventsArray, event);
+  }
+
+  json_object_set_new(rootEVENT,"Events",eventsArray);
+  json_dump_file(rootEVENT,filenameEVENT,0);
+  json_decref(rootEVENT);
+
+  return 0;
+}
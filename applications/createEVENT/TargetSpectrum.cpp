@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+#include <jansson.h>  // for Json
+#include <GroundMotionModel.h>
+
+//
+// TargetSpectrum: builds the target spectrum of the site in the BIM file (GeneralInformation location)
+// from a set of weighted earthquake scenarios, the output is the target file read by SelectRecords
+// and MatchSpectrum: {"periods":[..], "spectrum":[..], "damping":0.05, "lnSigma":[..], "units":"g"}
+//
+//   TargetSpectrum --filenameBIM BIM.json --filenameModel BSSA14.json --filenameScenarios scenarios.json
+//                  --filenameTarget target.json [--conditioningPeriod T --epsilon e | --targetSa Sa]
+//                  [--vs30 760 --minPeriod 0.01 --maxPeriod 10 --numPeriods 50]
+//
+// the scenarios file holds {"scenarios":[{"magnitude":7.0, "latitude":.., "longitude":.., "mechanism":"Reverse",
+// "weight":0.4}, ..]}; the model takes the Joyner-Boore distance Rjb, for which the epicentral distance
+// from the site to the scenario lat/lon stands in. That is close for small ruptures but overestimates
+// Rjb, and so underestimates the spectrum, for large ones near the site: a scenario "distance" (Rjb, km)
+// is used in its place if given. Without a conditioning period the scenario weighted median spectrum
+// is written
+//
+// the model file is not distributed with the application: it is built from the coefficient table in
+// the electronic supplement of Boore, Stewart, Seyhan & Atkinson (2014), Earthquake Spectra 30(3),
+// also in PEER report 2013/05. Each column of the table becomes an array of the json file under the
+// names read by GroundMotionModel::load (e0..e6, Mh, c1..c3, Mref, Rref, h, Dc3, c, Vc, Vref, f1, f3..f5,
+// R1, R2, DfR, DfV, V1, V2, phi1, phi2, tau1, tau2), the period column as "periods" with PGA at 0; the
+// PGV row is left out and Dc3 is taken from the column of the region of the site
+//
+
+#define PI 3.14159265358979323846
+
+// great circle distance in km
+static double
+siteDistance(double lat1, double lon1, double lat2, double lon2)
+{
+  double dLat = (lat2 - lat1) * PI / 180.0;
+  double dLon = (lon2 - lon1) * PI / 180.0;
+  double a = sin(dLat/2)*sin(dLat/2) + cos(lat1*PI/180.0)*cos(lat2*PI/180.0)*sin(dLon/2)*sin(dLon/2);
+  return 6371.0 * 2.0 * atan2(sqrt(a), sqrt(1.0-a));
+}
+
+static int
+parseMechanism(const char *mechanism)
+{
+  if (mechanism == NULL)
+    return ScenarioSet::Unspecified;
+  else if (strcmp(mechanism, "StrikeSlip") == 0 || strcmp(mechanism, "Strike-Slip") == 0)
+    return ScenarioSet::StrikeSlip;
+  else if (strcmp(mechanism, "Normal") == 0)
+    return ScenarioSet::Normal;
+  else if (strcmp(mechanism, "Reverse") == 0 || strcmp(mechanism, "Thrust") == 0)
+    return ScenarioSet::Reverse;
+  return ScenarioSet::Unspecified;
+}
+
+int main(int argc, char **argv)
+{
+  char *filenameBIM = NULL;
+  char *filenameModel = NULL;
+  char *filenameScenarios = NULL;
+  char *filenameTarget = NULL;
+  double conditioningPeriod = 0.0;
+  double epsilonValue = 1.0;
+  double targetSa = 0.0;
+  double vs30 = 0.0;
+  double minPeriod = 0.01;
+  double maxPeriod = 10.0;
+  int numPeriods = 50;
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--filenameBIM") ==0) {
+      arg++;
+      filenameBIM = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameModel") ==0) {
+      arg++;
+      filenameModel = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameScenarios") ==0) {
+      arg++;
+      filenameScenarios = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameTarget") ==0) {
+      arg++;
+      filenameTarget = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--conditioningPeriod") ==0) {
+      arg++;
+      conditioningPeriod = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--epsilon") ==0) {
+      arg++;
+      epsilonValue = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--targetSa") ==0) {
+      arg++;
+      targetSa = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--vs30") ==0) {
+      arg++;
+      vs30 = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--minPeriod") ==0) {
+      arg++;
+      minPeriod = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--maxPeriod") ==0) {
+      arg++;
+      maxPeriod = atof(argv[arg]);
+    }
+    else if (strcmp(argv[arg], "--numPeriods") ==0) {
+      arg++;
+      numPeriods = atoi(argv[arg]);
+    }
+
+    arg++;
+  }
+
+  if (filenameBIM == 0 || filenameModel == 0 || filenameScenarios == 0 || filenameTarget == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  if (numPeriods < 2 || minPeriod <= 0.0 || maxPeriod <= minPeriod) {
+    std::cerr << "ERROR - invalid period range\n";
+    exit(-1);
+  }
+
+  //
+  // site location (and Vs30 if not given) from the BIM
+  //
+
+  json_error_t error;
+  json_t *rootBIM = json_load_file(filenameBIM, 0, &error);
+  if (rootBIM == NULL) {
+    std::cerr << "ERROR - could not parse " << filenameBIM << ": " << error.text << "\n";
+    exit(-1);
+  }
+
+  json_t *genInfo = json_object_get(rootBIM,"GeneralInformation");
+  json_t *location = json_object_get(genInfo,"location");
+  double siteLat = json_number_value(json_object_get(location,"latitude"));
+  double siteLon = json_number_value(json_object_get(location,"longitude"));
+
+  if (vs30 <= 0.0) {
+    json_t *vs30Obj = json_object_get(genInfo,"vs30");
+    vs30 = (vs30Obj != NULL) ? json_number_value(vs30Obj) : 760.0;
+  }
+  json_decref(rootBIM);
+
+  //
+  // scenarios
+  //
+
+  json_t *rootScenarios = json_load_file(filenameScenarios, 0, &error);
+  if (rootScenarios == NULL) {
+    std::cerr << "ERROR - could not parse " << filenameScenarios << ": " << error.text << "\n";
+    exit(-1);
+  }
+
+  ScenarioSet theScenarios;
+
+  json_t *scenariosArray = json_object_get(rootScenarios,"scenarios");
+  int index;
+  json_t *value;
+  json_array_foreach(scenariosArray, index, value) {
+    double M = json_number_value(json_object_get(value,"magnitude"));
+    double R;
+    json_t *distanceObj = json_object_get(value,"distance");
+    if (distanceObj != NULL)
+      R = json_number_value(distanceObj);
+    else // epicentral distance as Rjb, see above
+      R = siteDistance(siteLat, siteLon,
+                       json_number_value(json_object_get(value,"latitude")),
+                       json_number_value(json_object_get(value,"longitude")));
+    int mechanism = parseMechanism(json_string_value(json_object_get(value,"mechanism")));
+    json_t *weightObj = json_object_get(value,"weight");
+    double weight = (weightObj != NULL) ? json_number_value(weightObj) : 1.0;
+
+    theScenarios.add(M, R, vs30, mechanism, weight);
+  }
+  json_decref(rootScenarios);
+
+  if (theScenarios.size() == 0) {
+    std::cerr << "ERROR - no scenarios in " << filenameScenarios << "\n";
+    exit(-1);
+  }
+
+  //
+  // conditional mean (or median) spectrum
+  //
+
+  GroundMotionModel theModel;
+  if (theModel.load(filenameModel) < 0)
+    exit(-1);
+
+  vector<double> periods(numPeriods);
+  for (int i=0; i<numPeriods; i++)
+    periods[i] = minPeriod * pow(maxPeriod/minPeriod, i/(numPeriods-1.0));
+
+  ConditionalMeanSpectrum theCMS(theModel);
+  vector<double> epsilon(theScenarios.size(), epsilonValue);
+  if (conditioningPeriod > 0.0 && targetSa > 0.0) {
+    if (theCMS.getEpsilon(theScenarios, conditioningPeriod, log(targetSa), epsilon) < 0) {
+      std::cerr << "ERROR - could not compute epsilon at the conditioning period " << conditioningPeriod << "\n";
+      exit(-1);
+    }
+  }
+
+  vector<double> lnMean, lnSigma;
+  if (theCMS.compute(theScenarios, periods, conditioningPeriod, epsilon, lnMean, lnSigma) < 0)
+    exit(-1);
+
+  json_t *rootTarget = json_object();
+  json_t *periodsArray = json_array();
+  json_t *spectrumArray = json_array();
+  json_t *sigmaArray = json_array();
+  for (int i=0; i<numPeriods; i++) {
+    json_array_append_new(periodsArray, json_real(periods[i]));
+    json_array_append_new(spectrumArray, json_real(exp(lnMean[i])));
+    json_array_append_new(sigmaArray, json_real(lnSigma[i]));
+  }
+  json_object_set_new(rootTarget,"periods",periodsArray);
+  json_object_set_new(rootTarget,"spectrum",spectrumArray);
+  json_object_set_new(rootTarget,"lnSigma",sigmaArray);
+  json_object_set_new(rootTarget,"damping",json_real(0.05));
+  json_object_set_new(rootTarget,"units",json_string("g"));
+  if (conditioningPeriod > 0.0)
+    json_object_set_new(rootTarget,"conditioningPeriod",json_real(conditioningPeriod));
+
+  json_dump_file(rootTarget,filenameTarget,0);
+  json_decref(rootTarget);
+
+  return 0;
+}
@@ -0,0 +1,256 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <iostream>
+#include <cmath>
+using namespace std;
+
+#include <jansson.h>  // for Json
+#include <Units.h>
+#include <EventReader.h>
+#include <EventUnits.h>
+#include <ResponseSpectrum.h>
+#include <IntensityMeasures.h>
+#include <EDPCatalog.h>
+#include <EDPWriter.h>
+
+//
+// ExtractIMs: writes intensity measures of every dof of every Seismic event of an EVENT file as
+// the EDPs, so that the spectral ordinates can be sampled directly. The measures are the ones
+// of the EDPCatalog request (BIM "IntensityMeasures" or --measures/--periods), in its order:
+//
+//   PGA          peak ground acceleration         (length/time^2)
+//   SA_<T>       pseudo spectral acceleration at each period T, "period" holds T (length/time^2)
+//   PGV          peak ground velocity             (length/time)
+//   PGD          peak ground displacement         (length)
+//   AI           Arias intensity                  (length/time)
+//   D5_95        5-95% significant duration      (time)
+//
+// all in the units of the BIM (GeneralInformation "units"); if it has none PGA and SA are in g, as
+// ExtractPGA writes them, and the others in m and s. The motion is converted from the event units,
+// from g if the event has none, as ExtractPGA does
+//
+//   ExtractIMs --filenameBIM BIM.json --filenameEVENT EVENT.json --filenameEDP EDP.json
+//              [--measures PGA,SA,PGV --periods 0.2,0.5,1.0 --damping 0.05
+//               --filenameResults results.out --getRV]
+//
+// with --filenameResults the values are also written to the results.out of the dakota interface
+// the EDP application is to be given the same request so its template matches
+//
+
+int main(int argc, char **argv)
+{
+  char *filenameBIM = NULL;
+  char *filenameEVENT = NULL;
+  char *filenameEDP = NULL;
+  char *measureList = NULL;
+  char *periodList = NULL;
+  char *filenameResults = NULL;
+  double damping = -1.0;
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--filenameBIM") ==0) {
+      arg++;
+      filenameBIM = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameEVENT") ==0) {
+      arg++;
+      filenameEVENT = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameEDP") ==0) {
+      arg++;
+      filenameEDP = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--filenameResults") ==0) {
+      arg++;
+      filenameResults = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--measures") ==0) {
+      arg++;
+      measureList = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--periods") ==0) {
+      arg++;
+      periodList = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--damping") ==0) {
+      arg++;
+      damping = atof(argv[arg]);
+    }
+
+    arg++;
+  }
+
+  if (filenameEVENT == 0 || filenameEDP == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  EDPCatalog theCatalog;
+  if (theCatalog.configure(filenameBIM, measureList, periodList) < 0)
+    exit(-1);
+  const vector<EDPCatalog::Entry> &entries = theCatalog.getEntries();
+  int numEntries = entries.size();
+
+  const vector<double> &periods = theCatalog.getPeriods();
+  int numPeriods = periods.size();
+  if (damping < 0.0)
+    damping = theCatalog.getDamping();
+
+  // the oscillator coefficients depend on the time step only, one set per dT
+  map<double, unique_ptr<ResponseSpectrum> > spectra;
+
+  // the EDPs are in the units of the BIM; with none, m and s and the accelerations in g
+  Units::UnitSystem bimUnits;
+  int hasUnits = 0;
+  if (filenameBIM != 0 && (hasUnits = readBIMUnits(filenameBIM, bimUnits)) < 0)
+    exit(-1);
+  if (hasUnits == 0) {
+    bimUnits.lengthUnit = Units::LengthUnit::Meter;
+    bimUnits.timeUnit = Units::TimeUnit::Second;
+  }
+  double gravity = Units::GetGravity(bimUnits);
+  double accelerationFactor = (hasUnits == 0) ? 1.0/gravity : 1.0;
+
+  //
+  // each event is processed as soon as it is read and its samples are then released, so the
+  // memory does not grow with the number of events; only the text of the EDP file is kept
+  //
+
+  EDPWriter theWriter;
+
+  EventReader theReader(EventReader::ReadData);
+  int result = theReader.read(filenameEVENT, [&](EventRecord &theEvent) {
+
+    if (theEvent.type != "Seismic") {
+      printf("WARNING event type %s not Seismic NO OUTPUT", theEvent.type.c_str());
+    }
+
+    int numPattern = theEvent.pattern.size();
+    if (numPattern == 0) {
+      std::cerr << "ERROR no patterns with Seismic event " << theEvent.name << "\n";
+      return false;
+    }
+
+    // factors from the units of the event to those of the BIM, applied to the motion and its dT
+    double unitConversionFactor = getUnitConversionFactor(theEvent, &bimUnits);
+    double timeConversionFactor = getTimeConversionFactor(theEvent, bimUnits);
+
+    //
+    // the catalog entries of each series, a series loaded in several dofs is only done once
+    //
+
+    map<int, vector<double> > seriesValues;
+    vector<int> dofs;
+    vector<const vector<double> *> dofValues;
+    vector<double> noMotion(numEntries, 0.0);
+
+    for (int ii=0; ii<numPattern; ii++) {
+      const EventPattern &thePattern = theEvent.pattern[ii];
+      if (thePattern.dof == 0) {
+        std::cerr << "ERROR no dof with Seismic event pattern " << ii << "\n";
+        return false;
+      }
+      dofs.push_back(thePattern.dof);
+
+      int seriesIndex = theEvent.findSeries(thePattern.timeSeries);
+      if (seriesIndex < 0 || theEvent.timeSeries[seriesIndex].type != "Value") {
+        dofValues.push_back(&noMotion);
+        continue;
+      }
+
+      map<int, vector<double> >::iterator found = seriesValues.find(seriesIndex);
+      if (found != seriesValues.end()) {
+        dofValues.push_back(&found->second);
+        continue;
+      }
+
+      const EventTimeSeries &theSeries = theEvent.timeSeries[seriesIndex];
+      int numSteps = theSeries.file ? theSeries.file->getNumSteps() : theSeries.data.size();
+      double dT = (theSeries.dT > 0.0) ? theSeries.dT : theEvent.dT;
+      if (dT <= 0.0) {
+        std::cerr << "ERROR no dT for time series " << theSeries.name << "\n";
+        return false;
+      }
+      dT *= timeConversionFactor;
+
+      const double *data = theSeries.getData();
+      double scale = theSeries.factor * unitConversionFactor;
+      vector<double> accel(numSteps);
+      for (int i=0; i<numSteps; i++)
+        accel[i] = data[i] * scale;
+
+      // spectral ordinates of all periods in one pass
+      vector<double> Sd(numPeriods), Sa(numPeriods);
+      if (theCatalog.hasMeasure(EDPCatalog::SA)) {
+        unique_ptr<ResponseSpectrum> &theSpectrum = spectra[dT];
+        if (!theSpectrum)
+          theSpectrum.reset(new ResponseSpectrum(periods, damping, dT));
+        theSpectrum->compute(accel.data(), numSteps, Sd.data(), Sa.data());
+      }
+
+      vector<double> &values = seriesValues[seriesIndex];
+      values.resize(numEntries);
+      int periodIndex = 0;
+      for (int j=0; j<numEntries; j++) {
+        switch (entries[j].measure) {
+        case EDPCatalog::PGA:
+          // the peak was found as the series was read, the factor is applied to it
+          values[j] = theSeries.peak * fabs(scale) * accelerationFactor;
+          break;
+        case EDPCatalog::SA:
+          values[j] = Sa[periodIndex++] * accelerationFactor;
+          break;
+        case EDPCatalog::PGV:
+          values[j] = getPeakVelocity(accel.data(), numSteps, dT);
+          break;
+        case EDPCatalog::PGD:
+          values[j] = getPeakDisplacement(accel.data(), numSteps, dT);
+          break;
+        case EDPCatalog::AI:
+          values[j] = getAriasIntensity(accel.data(), numSteps, dT, gravity);
+          break;
+        case EDPCatalog::D5_95:
+          values[j] = getSignificantDuration(accel.data(), numSteps, dT);
+          break;
+        default:
+          break;
+        }
+      }
+
+      dofValues.push_back(&values);
+    }
+
+    //
+    // the responses, in the order of the EDP template
+    //
+
+    theWriter.beginEvent(theEvent.name.c_str());
+    vector<double> scalarData(numPattern);
+    for (int j=0; j<numEntries; j++) {
+      for (int ii=0; ii<numPattern; ii++)
+        scalarData[ii] = (*dofValues[ii])[j];
+      theWriter.addResponse(entries[j].type.c_str(), dofs.data(), scalarData.data(), numPattern,
+                            (entries[j].measure == EDPCatalog::SA) ? entries[j].period : 0.0);
+    }
+    theWriter.endEvent();
+
+    return true;
+  });
+
+  if (result < 0)
+    exit(-1);
+
+  if (theWriter.writeEDP(filenameEDP) < 0)
+    exit(-1);
+  if (filenameResults != 0 && theWriter.writeResults(filenameResults) < 0)
+    exit(-1);
+
+  return 0;
+}
@@ -3,19 +3,523 @@
 #include <string.h>
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <iostream>
 #include <cmath>
+#include <thread>
+#include <atomic>
 using namespace std;
 
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/file.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <glob.h>
+#endif
+
 #include <jansson.h>  // for Json
 #include <Units.h>
+#include <EventReader.h>
+#include <EventUnits.h>
+#include <EDPCatalog.h>
+#include <EDPWriter.h>
+#include <WorkerSocket.h>
+
+//
+// ExtractPGA: writes the PGA of every dof of every Seismic event of an EVENT file as the EDPs,
+// in the units of the BIM (GeneralInformation "units") or in g if the BIM has none. The EDP
+// template comes from the EDPCatalog, so a BIM asking for other intensity measures is refused
+// (ExtractIMs writes them)
+//
+//   ExtractPGA --filenameBIM BIM.json --filenameEVENT EVENT.json --filenameEDP EDP.json
+//              [--filenameResults results.out --getRV]
+//
+// with --filenameResults the PGAs are also written to the results.out of the dakota interface
+//
+// or runs as a persistent worker, taking work items from ExtractPGAClient over a unix socket so
+// that a sample does not pay for starting the application. The worker exits once it has been
+// idle for the given number of seconds (default 300):
+//
+//   ExtractPGA --server ExtractPGA.sock [--idleTimeout 300]
+//
+// the socket is placed as WorkerSocket describes and only connections of the same user are
+// served. One worker holds <socket>.lock while it runs, a second one started on the same socket
+// exits at once.
+//
+// each work item is one line "EVENT path<TAB>EDP path[<TAB>BIM path[<TAB>results path]]\n"
+// (absolute paths, the BIM field may be left empty), answered with "0\n" on success or "-1\n" on
+// failure; a connection may send any number of items, and is closed if it sends nothing for
+// CONNECTION_TIMEOUT seconds. Connections are served concurrently, each on its own thread
+//
+// or re-extracts the PGAs of a whole study in one go, writing them to one table (standard output
+// if no --filenameOut) and, with --filenameEDP, an EDP file next to each event file:
+//
+//   ExtractPGA --batch "workdir.*/EVENT.json" [--filenameBIM BIM.json --filenameOut PGA.txt
+//              --filenameEDP EDP.json --numThreads n]
+//   ExtractPGA --batch eventFiles.txt ...
+//
+
+//
+// the PGA of each dof of each event
+//
+
+struct EventPGA
+{
+    string name;
+    vector<int> dofs;
+    vector<double> PGA;
+};
+
+//
+// the EDP application writes its template from the catalog of the BIM request, only a request for
+// the PGA alone can be filled here
+//
+
+static int
+checkCatalog(const char *filenameBIM)
+{
+    EDPCatalog theCatalog;
+    if (theCatalog.configure(filenameBIM, 0, 0) < 0)
+      return -1;
+
+    const vector<EDPCatalog::Entry> &entries = theCatalog.getEntries();
+    if (entries.size() != 1 || entries[0].measure != EDPCatalog::PGA) {
+      std::cerr << "ERROR - " << filenameBIM << " asks for intensity measures other than PGA, use ExtractIMs\n";
+      return -1;
+    }
+    return 0;
+}
+
+static int
+readPGA(EventReader &theReader, vector<EventRecord> &events, const char *filenameEVENT,
+	const Units::UnitSystem *bimUnits, vector<EventPGA> &results)
+{
+    results.clear();
+
+    // read the events, each data array is reduced to its peak as it is parsed
+    if (theReader.read(filenameEVENT, events) < 0)
+      return -1;
+
+    for (unsigned int index=0; index<events.size(); index++) {
+      const EventRecord &theEvent = events[index];
+
+      // check earthquake
+      const char *eventType = theEvent.type.c_str();
+
+      if (strcmp(eventType,"Seismic") != 0) {
+	printf("WARNING event type %s not Seismic NO OUTPUT", eventType);
+      }
+
+
+      // get scaling factor for units, applied with the series factor to the peak
+      double unitConversionFactor = getUnitConversionFactor(theEvent, bimUnits);
+
+      int numPattern = theEvent.pattern.size();
+      if (numPattern == 0) {
+	std::cerr << "ERROR no patterns with Seismic event " << theEvent.name << " in " << filenameEVENT << "\n";
+	return -1;
+      }
+
+      results.push_back(EventPGA());
+      EventPGA &theResult = results.back();
+      theResult.name = theEvent.name;
+
+      for (int ii=0; ii<numPattern; ii++) {
+	const EventPattern &thePattern = theEvent.pattern[ii];
+	if (thePattern.dof == 0) {
+	  std::cerr << "ERROR no dof with Seismic event pattern " << ii << " in " << filenameEVENT << "\n";
+	  return -1;
+	}
+
+	// find the time series matching name, its peak was found when it was read
+	double PGA = 0.0;
+	int seriesIndex = theEvent.findSeries(thePattern.timeSeries);
+	if (seriesIndex >= 0) {
+	  const EventTimeSeries &theSeries = theEvent.timeSeries[seriesIndex];
+	  if (theSeries.type == "Value")
+	    PGA = theSeries.peak * unitConversionFactor * fabs(theSeries.factor);
+	}
+
+	theResult.dofs.push_back(thePattern.dof);
+	theResult.PGA.push_back(PGA);
+      }
+    }
+
+    return results.size();
+}
+
+//
+// the EDP file (and results.out if asked for) is written straight from the PGAs by the writer,
+// whose buffer is kept from file to file
+//
+
+static int
+writeEDP(const vector<EventPGA> &results, const char *filenameEDP, const char *filenameResults,
+	 EDPWriter &theWriter)
+{
+    theWriter.clear();
+
+    for (unsigned int index=0; index<results.size(); index++) {
+      const EventPGA &theResult = results[index];
+
+      // max ground acceleration of each dof
+      theWriter.beginEvent(theResult.name.c_str());
+      theWriter.addResponse(EDPCatalog::getDefinition(EDPCatalog::PGA).type, theResult.dofs.data(), theResult.PGA.data(), theResult.dofs.size());
+      theWriter.endEvent();
+    }
+
+    if (theWriter.writeEDP(filenameEDP) < 0)
+      return -1;
+    if (filenameResults != 0 && theWriter.writeResults(filenameResults) < 0)
+      return -1;
+    return 0;
+}
+
+static int
+extractPGA(EventReader &theReader, EDPWriter &theWriter, const char *filenameBIM,
+	   const char *filenameEVENT, const char *filenameEDP, const char *filenameResults)
+{
+    Units::UnitSystem bimUnits;
+    int hasUnits = 0;
+    if (filenameBIM != 0 && (checkCatalog(filenameBIM) < 0 || (hasUnits = readBIMUnits(filenameBIM, bimUnits)) < 0))
+      return -1;
+
+    vector<EventRecord> events;
+    vector<EventPGA> results;
+    if (readPGA(theReader, events, filenameEVENT, hasUnits ? &bimUnits : 0, results) < 0)
+      return -1;
+    return writeEDP(results, filenameEDP, filenameResults, theWriter);
+}
+
+//
+// batch mode: the event files named by a glob pattern, or listed one per line in a file, are
+// shared out to a pool of threads; each thread keeps its reader and event buffers from file to
+// file. The PGAs go to one table, a row per file, event and dof, in the order of the files
+//
+
+static int
+listBatchFiles(const char *batch, vector<string> &files)
+{
+    files.clear();
+
+    bool pattern = (strpbrk(batch, "*?[") != NULL);
+    if (pattern == false) {
+      ifstream listFile(batch);
+      if (!listFile.is_open()) {
+	std::cerr << "ERROR - could not open " << batch << "\n";
+	return -1;
+      }
+      string line;
+      while (getline(listFile, line)) {
+	size_t last = line.find_last_not_of(" \t\r");
+	if (last == string::npos)
+	  continue;
+	files.push_back(line.substr(0, last+1));
+      }
+      return files.size();
+    }
+
+#ifndef _WIN32
+    glob_t matches;
+    if (glob(batch, 0, NULL, &matches) == 0) {
+      for (size_t i=0; i<matches.gl_pathc; i++)
+	files.push_back(matches.gl_pathv[i]);
+    }
+    globfree(&matches);
+    return files.size();
+#else
+    std::cerr << "ERROR - glob patterns are not available on Windows, give a list file\n";
+    return -1;
+#endif
+}
+
+static string
+siblingPath(const string &filename, const char *name)
+{
+    size_t slash = filename.find_last_of("/\\");
+    if (slash == string::npos)
+      return string(name);
+    return filename.substr(0, slash+1) + name;
+}
+
+static int
+runBatch(const char *batch, const char *filenameBIM, const char *filenameEDP, const char *filenameOut, int numThreads)
+{
+    // one BIM for the whole study
+    Units::UnitSystem bimUnits;
+    int hasUnits = 0;
+    if (filenameBIM != 0 && (checkCatalog(filenameBIM) < 0 || (hasUnits = readBIMUnits(filenameBIM, bimUnits)) < 0))
+      return -1;
+
+    vector<string> files;
+    if (listBatchFiles(batch, files) <= 0) {
+      std::cerr << "ERROR - no event files for " << batch << "\n";
+      return -1;
+    }
+
+    int numFiles = files.size();
+    vector<vector<EventPGA> > results(numFiles);
+    vector<int> status(numFiles, 0);
+
+    if (numThreads < 1)
+      numThreads = 1;
+    if (numThreads > numFiles)
+      numThreads = numFiles;
+
+    std::atomic<int> nextFile(0);
+    auto worker = [&]() {
+      EventReader theReader(EventReader::PeakOnly);
+      EDPWriter theWriter;
+      vector<EventRecord> events;
+      int i;
+      while ((i = nextFile++) < numFiles) {
+	status[i] = readPGA(theReader, events, files[i].c_str(), hasUnits ? &bimUnits : 0, results[i]);
+	if (status[i] >= 0 && filenameEDP != 0)
+	  status[i] = writeEDP(results[i], siblingPath(files[i], filenameEDP).c_str(), 0, theWriter);
+      }
+    };
+
+    vector<std::thread> threads;
+    for (int t=1; t<numThreads; t++)
+      threads.push_back(std::thread(worker));
+    worker();
+    for (unsigned int t=0; t<threads.size(); t++)
+      threads[t].join();
+
+    FILE *fp = (filenameOut != 0) ? fopen(filenameOut, "w") : stdout;
+    if (fp == NULL) {
+      std::cerr << "ERROR - could not create " << filenameOut << "\n";
+      return -1;
+    }
+
+    int numFailed = 0;
+    fprintf(fp, "file\tevent\tdof\tPGA\n");
+    for (int i=0; i<numFiles; i++) {
+      if (status[i] < 0) {
+	numFailed++;
+	continue;
+      }
+      for (unsigned int j=0; j<results[i].size(); j++) {
+	const EventPGA &theResult = results[i][j];
+	for (unsigned int k=0; k<theResult.dofs.size(); k++)
+	  fprintf(fp, "%s\t%s\t%d\t%.10g\n", files[i].c_str(), theResult.name.c_str(),
+		  theResult.dofs[k], theResult.PGA[k]);
+      }
+    }
+
+    if (fp != stdout)
+      fclose(fp);
+
+    if (numFailed != 0) {
+      std::cerr << "ERROR - " << numFailed << " of " << numFiles << " event files failed\n";
+      return -1;
+    }
+    return 0;
+}
+
+#ifndef _WIN32
+
+#define CONNECTION_TIMEOUT 60
+
+//
+// the work items of one connection, until the client closes it or goes quiet
+//
+
+static void
+serveConnection(int fd)
+{
+    EventReader theReader(EventReader::PeakOnly);
+    EDPWriter theWriter;
+
+    string pending;
+    char buffer[4096];
+
+    while (true) {
+      ssize_t numRead = read(fd, buffer, sizeof(buffer));
+      if (numRead < 0 && errno == EINTR)
+	continue;
+      if (numRead <= 0)
+	return;
+      pending.append(buffer, numRead);
+
+      size_t end;
+      while ((end = pending.find('\n')) != string::npos) {
+	string item = pending.substr(0, end);
+	pending.erase(0, end+1);
+
+	// EVENT, EDP and the optional BIM and results.out, an empty field is not given
+	vector<string> fields;
+	size_t start = 0, tab;
+	while ((tab = item.find('\t', start)) != string::npos) {
+	  fields.push_back(item.substr(start, tab-start));
+	  start = tab+1;
+	}
+	fields.push_back(item.substr(start));
+	fields.resize(4);
+
+	int result = -1;
+	if (fields[0].size() != 0 && fields[1].size() != 0) {
+	  result = extractPGA(theReader, theWriter, fields[2].size() ? fields[2].c_str() : 0,
+			      fields[0].c_str(), fields[1].c_str(),
+			      fields[3].size() ? fields[3].c_str() : 0);
+	} else
+	  std::cerr << "ERROR - malformed work item: " << item << "\n";
+
+	const char *reply = (result == 0) ? "0\n" : "-1\n";
+	if (write(fd, reply, strlen(reply)) < 0)
+	  return;
+      }
+    }
+}
+
+//
+// true if the peer of a connection runs as the same user as the worker
+//
+
+static bool
+isSameUser(int fd)
+{
+#if defined(__linux__)
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0)
+      return false;
+    return credentials.uid == getuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (getpeereid(fd, &uid, &gid) != 0)
+      return false;
+    return uid == getuid();
+#endif
+}
+
+static int
+runServer(const char *socketName, int idleTimeout)
+{
+    string socketPath;
+    if (getWorkerSocketPath(socketName, socketPath) < 0)
+      return -1;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+      std::cerr << "ERROR - socket path too long: " << socketPath << "\n";
+      return -1;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    //
+    // the lock is held for as long as the worker runs: a socket file left without it is stale and
+    // can be replaced, and a second worker on the same path leaves the running one alone
+    //
+
+    string lockPath = socketPath + ".lock";
+    int lockFd = open(lockPath.c_str(), O_RDWR | O_CREAT, 0600);
+    if (lockFd < 0) {
+      std::cerr << "ERROR - could not open " << lockPath << ": " << strerror(errno) << "\n";
+      return -1;
+    }
+    if (flock(lockFd, LOCK_EX | LOCK_NB) != 0) {
+      close(lockFd);
+      return (errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    // a client that goes away must not take the worker down with it
+    signal(SIGPIPE, SIG_IGN);
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+      std::cerr << "ERROR - could not create socket\n";
+      close(lockFd);
+      return -1;
+    }
+
+    unlink(socketPath.c_str());
+    if (bind(listenFd, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listenFd, 64) != 0) {
+      std::cerr << "ERROR - could not listen on " << socketPath << ": " << strerror(errno) << "\n";
+      close(listenFd);
+      unlink(socketPath.c_str());
+      close(lockFd);
+      return -1;
+    }
+
+    //
+    // each connection is served on its own thread, with its own reader and writer; the worker is
+    // only idle while no connection is open
+    //
+
+    std::atomic<int> numOpen(0);
+
+    while (true) {
+      struct pollfd waitFd;
+      waitFd.fd = listenFd;
+      waitFd.events = POLLIN;
+      int ready = poll(&waitFd, 1, (idleTimeout > 0) ? idleTimeout*1000 : -1);
+      if (ready < 0 && errno == EINTR)
+	continue;
+      if (ready < 0)
+	break;
+      if (ready == 0) {
+	if (numOpen == 0)
+	  break;
+	continue;
+      }
+
+      int fd = accept(listenFd, 0, 0);
+      if (fd < 0)
+	continue;
+
+      if (isSameUser(fd) == false) {
+	std::cerr << "ERROR - connection from another user refused\n";
+	close(fd);
+	continue;
+      }
+
+      struct timeval timeout;
+      timeout.tv_sec = CONNECTION_TIMEOUT;
+      timeout.tv_usec = 0;
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+      numOpen++;
+      std::thread([fd, &numOpen]() {
+	serveConnection(fd);
+	close(fd);
+	numOpen--;
+      }).detach();
+    }
+
+    close(listenFd);
+    unlink(socketPath.c_str());
+    close(lockFd);
+
+    // the connections still open are left to finish
+    while (numOpen != 0)
+      usleep(10000);
+    return 0;
+}
+
+#endif
 
 int main(int argc, char **argv)
 {
   char *filenameINPUT = NULL;
   char *filenameEVENT = NULL;
   char *filenameEDP = NULL;
+  char *socketPath = NULL;
+  char *batch = NULL;
+  char *filenameOut = NULL;
+  char *filenameResults = NULL;
+  int idleTimeout = 300;
+  int numThreads = std::thread::hardware_concurrency();
   bool getRV = false;
 
   int arg = 1;
@@ -32,188 +536,67 @@ int main(int argc, char **argv)
 	arg++;
 	filenameINPUT = argv[arg];
       }
+      else if (strcmp(argv[arg], "--filenameResults") ==0) {
+	arg++;
+	filenameResults = argv[arg];
+      }
+      else if (strcmp(argv[arg], "--server") ==0) {
+	arg++;
+	socketPath = argv[arg];
+      }
+      else if (strcmp(argv[arg], "--idleTimeout") ==0) {
+	arg++;
+	idleTimeout = atoi(argv[arg]);
+      }
+      else if (strcmp(argv[arg], "--batch") ==0) {
+	arg++;
+	batch = argv[arg];
+      }
+      else if (strcmp(argv[arg], "--filenameOut") ==0) {
+	arg++;
+	filenameOut = argv[arg];
+      }
+      else if (strcmp(argv[arg], "--numThreads") ==0) {
+	arg++;
+	numThreads = atoi(argv[arg]);
+      }
       else if (strcmp(argv[arg], "--getRV") ==0) {
 	getRV = true;
       }
-      
+
       arg++;
     }
 
-    //
-    // if not all args present, exit with error
-    //
-
-    if (filenameEVENT == 0) {
-      std::cerr << "ERROR - missing input args\n";
+    if (socketPath != 0) {
+#ifndef _WIN32
+      if (runServer(socketPath, idleTimeout) < 0)
+	exit(-1);
+      return 0;
+#else
+      std::cerr << "ERROR - server mode is not available on Windows\n";
       exit(-1);
+#endif
     }
 
-    // create output JSON object
-    json_t *rootEDP = json_object();
-
-    // place an empty random variable field
-    json_t *rvArray=json_array();   
-    json_object_set(rootEDP,"RandomVariables",rvArray);
+    if (batch != 0) {
+      if (runBatch(batch, filenameINPUT, filenameEDP, filenameOut, numThreads) < 0)
+	exit(-1);
+      return 0;
+    }
 
     //
-    // for each event we create the edp's
+    // if not all args present, exit with error
     //
 
-    json_t *eventArray = json_array(); // for each analysis event
-
-    // load SAM and EVENT files
-    json_error_t error;
-
-    json_t *rootEVENT = json_load_file(filenameEVENT, 0, &error);
-    json_t *eventsArray = json_object_get(rootEVENT,"Events");  
-    
-    int index;
-    json_t *value;
-    
-    int numEDP = 0;
-    
-    json_array_foreach(eventsArray, index, value) {
-      
-      // check earthquake
-      json_t *type = json_object_get(value,"type");  
-      const char *eventType = json_string_value(type);
-      
-      if (strcmp(eventType,"Seismic") != 0) {
-	json_object_clear(rootEVENT);
-	printf("WARNING event type %s not Seismic NO OUTPUT", eventType);
-      }
-
-
-      // get scaling factor for units
-      double unitConversionFactor = 1.0;
-      /*
-      // get unitConversion factor
-      json_t* evtUnitsJson = json_object_get(value, "units");
-      Units::UnitSystem eventUnits;
-      
-      if(evtUnitsJson != NULL) {
-	json_t* evtLengthJson = json_object_get(evtUnitsJson, "length");
-	if(NULL != evtLengthJson)
-	  eventUnits.lengthUnit = Units::ParseLengthUnit(json_string_value(evtLengthJson));
-	
-	json_t* evtTimeJson = json_object_get(evtUnitsJson, "time");
-	if(NULL != evtTimeJson)
-	  eventUnits.timeUnit = Units::ParseTimeUnit(json_string_value(evtTimeJson));
-	
-	unitConversionFactor = Units::GetAccelerationFactor(eventUnits, bimUnits);
-      } else {
-	std::cerr << "Warning! Event file has no units!, assuming acceleration and units in g units" << std::endl;
-	eventUnits.lengthUnit = Units::LengthUnit::Meter;
-	eventUnits.timeUnit = Units::TimeUnit::Second;
-	
-	unitConversionFactor = 9.81 * Units::GetAccelerationFactor(eventUnits, bimUnits);
-      }
-      */
-
-      // add the EDP for the event
-      json_t *eventObj = json_object();
-      
-      json_t *name = json_object_get(value,"name"); 
-      const char *eventName = json_string_value(name);
-      json_object_set(eventObj,"name",json_string(eventName));
-
-      int numDOF = 0;
-      json_t *theDOFs = json_array();
-      json_t *thePGAs = json_array();
-      int *tDOFs = 0;
-      json_t *patternArray = json_object_get(value,"pattern");
-      int numPattern = json_array_size(patternArray);
-
-      json_t *timeSeriesArray = json_object_get(value,"timeSeries");
-      int numSeries = json_array_size(timeSeriesArray);
-
-      tDOFs = new int[numPattern];
-      double *maxPGAs = new double[numPattern];
-
-      if (numPattern != 0) {
-	for (int ii=0; ii<numPattern; ii++) {
-	  json_t *thePattern = json_array_get(patternArray, ii);
-	  json_t *theDof = json_object_get(thePattern, "dof");
-	  json_t *theSeries = json_object_get(thePattern, "timeSeries");
-	  tDOFs[ii] = json_integer_value(theDof);
-	  if (theDof != 0) {
-	    json_array_append(theDOFs, theDof);
-	    numDOF++;
-	  } else {
-	    printf("ERROR no dof with Seismic event pattern %d", ii);
-	    exit(-1);
-	  }
-
-	  double PGA = 0.0;
-	  
-	  const char *timeSeriesName = json_string_value(theSeries);
-
-	  // loop over time series & find one wmatching name, loop over data & get Value
-	  for (int i=0; i<numSeries; i++) {
-	    json_t *theSeries = json_array_get(timeSeriesArray, i);
-	    json_t *theName = json_object_get(theSeries, "name");	    
-	    
-	    if (strcmp(timeSeriesName, json_string_value(theName)) == 0) {
-	      i = numSeries;
-	      const char *subType = json_string_value(json_object_get(theSeries,"type"));
-	      std::cerr << "subType: " << subType << "\n";
-	      if (strcmp(subType,"Value")  == 0) {
-		
-		double seriesFactor = 1.0;
-		json_t *seriesFactorObj = json_object_get(theSeries,"factor");
-		if (seriesFactorObj != NULL) {
-		  if (json_is_real(seriesFactorObj))
-		    seriesFactor = json_number_value(seriesFactorObj);
-		}
-		
-		double dt = json_number_value(json_object_get(theSeries,"dT"));
-		json_t *data = json_object_get(theSeries,"data");
-		
-		json_t *dataV;
-		int dataIndex;
-		json_array_foreach(data, dataIndex, dataV) {
-		  double accel = json_number_value(dataV) * unitConversionFactor * seriesFactor;
-		  double absAccel = fabs(accel);
-		  if (absAccel > PGA)
-		    PGA = absAccel;
-		}
-	      }
-	    }
-	  }
-
-	  maxPGAs[ii] = PGA;
-	  json_array_append(thePGAs, json_real(PGA));
-
-	}
-      } else {
-	printf("ERROR no patterns with Seismic event");
-	exit(-1);
-      }
-      
-      //    json_dump_file(eventObj,"TEST",0);
-
-      json_t *responsesArray = json_array(); // for each analysis event
-      
-      // max ground acceleration
-      json_t *responseA = json_object();
-      json_object_set(responseA,"type",json_string("PGA"));      
-      json_object_set(responseA,"dofs",theDOFs);
-      json_object_set(responseA,"scalar_data",thePGAs);
-      json_array_append(responsesArray,responseA);
-      numEDP += numDOF;
-
-      json_object_set(eventObj,"responses",responsesArray);
-      
-      json_array_append(eventArray,eventObj);
-
-      if (tDOFs != 0)
-	delete [] tDOFs;
+    if (filenameEVENT == 0 || filenameEDP == 0) {
+      std::cerr << "ERROR - missing input args\n";
+      exit(-1);
     }
 
-    json_object_set(rootEDP,"total_number_edp",json_integer(numEDP));  
-    json_object_set(rootEDP,"EngineeringDemandParameters",eventArray);  
-
-    json_dump_file(rootEDP,filenameEDP,0);   
+    EventReader theReader(EventReader::PeakOnly);
+    EDPWriter theWriter;
+    if (extractPGA(theReader, theWriter, filenameINPUT, filenameEVENT, filenameEDP, filenameResults) < 0)
+      exit(-1);
 
     return 0;
 }
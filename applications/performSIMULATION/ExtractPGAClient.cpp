@@ -0,0 +1,220 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+using namespace std;
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#else
+#include <process.h>
+#endif
+
+#include <WorkerSocket.h>
+
+//
+// ExtractPGAClient: stands in for ExtractPGA in the driver file. The work item is handed to a
+// persistent ExtractPGA worker over a unix socket (started on first use), so a sample costs a
+// connect and a write instead of starting the application and setting it up again:
+//
+//   ExtractPGAClient --filenameBIM BIM.json --filenameEVENT EVENT.json --filenameEDP EDP.json
+//                    [--filenameResults results.out --server ExtractPGA.sock --idleTimeout 300]
+//
+// the socket is found as WorkerSocket describes, as the worker places it. ExtractPGA is looked
+// for next to the client. With --getRV, or if no worker can be reached, the client runs
+// ExtractPGA itself with the same arguments, so the results never depend on the worker.
+//
+
+#ifndef _WIN32
+
+static string
+absolutePath(const char *filename)
+{
+  if (filename[0] == '/')
+    return string(filename);
+
+  char cwd[PATH_MAX];
+  if (getcwd(cwd, sizeof(cwd)) == NULL)
+    return string(filename);
+  return string(cwd) + "/" + filename;
+}
+
+static int
+connectWorker(const char *socketPath)
+{
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (strlen(socketPath) >= sizeof(address.sun_path))
+    return -1;
+  strcpy(address.sun_path, socketPath);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  if (connect(fd, (struct sockaddr *)&address, sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+//
+// start a detached worker, double forked so it is not left as our child
+//
+
+static void
+startWorker(const string &workerPath, const char *socketName, const char *idleTimeout)
+{
+  pid_t pid = fork();
+  if (pid < 0)
+    return;
+
+  if (pid == 0) {
+    setsid();
+    if (fork() != 0)
+      _exit(0);
+
+    int nullFd = open("/dev/null", O_RDWR);
+    if (nullFd >= 0) {
+      dup2(nullFd, 0);
+      dup2(nullFd, 1);
+      dup2(nullFd, 2);
+    }
+    execlp(workerPath.c_str(), workerPath.c_str(), "--server", socketName,
+	  "--idleTimeout", idleTimeout, (char *)NULL);
+    _exit(-1);
+  }
+
+  waitpid(pid, 0, 0);
+}
+
+static int
+sendWorkItem(int fd, const string &filenameEVENT, const string &filenameEDP, const string &filenameBIM,
+	     const string &filenameResults)
+{
+  string item = filenameEVENT + "\t" + filenameEDP;
+  if (filenameBIM.size() != 0 || filenameResults.size() != 0)
+    item += "\t" + filenameBIM;
+  if (filenameResults.size() != 0)
+    item += "\t" + filenameResults;
+  item += "\n";
+  if (write(fd, item.c_str(), item.size()) != (ssize_t)item.size())
+    return -2;
+
+  string reply;
+  char c;
+  while (true) {
+    ssize_t numRead = read(fd, &c, 1);
+    if (numRead < 0 && errno == EINTR)
+      continue;
+    if (numRead <= 0)
+      return -2;
+    if (c == '\n')
+      break;
+    reply += c;
+  }
+  return (reply == "0") ? 0 : -1;
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+  char *filenameBIM = NULL;
+  char *filenameResults = NULL;
+  char *filenameEVENT = NULL;
+  char *filenameEDP = NULL;
+  const char *socketName = "ExtractPGA.sock";
+  const char *idleTimeout = "300";
+  bool getRV = false;
+
+  // the arguments passed on to ExtractPGA when running it directly
+  vector<char *> args(1);
+
+  int arg = 1;
+  while (arg < argc) {
+    if (strcmp(argv[arg], "--server") ==0) {
+      arg++;
+      socketName = argv[arg];
+    }
+    else if (strcmp(argv[arg], "--idleTimeout") ==0) {
+      arg++;
+      idleTimeout = argv[arg];
+    }
+    else {
+      if (strcmp(argv[arg], "--filenameEVENT") ==0 && arg+1 < argc)
+	filenameEVENT = argv[arg+1];
+      else if (strcmp(argv[arg], "--filenameEDP") ==0 && arg+1 < argc)
+	filenameEDP = argv[arg+1];
+      else if (strcmp(argv[arg], "--filenameBIM") ==0 && arg+1 < argc)
+	filenameBIM = argv[arg+1];
+      else if (strcmp(argv[arg], "--filenameResults") ==0 && arg+1 < argc)
+	filenameResults = argv[arg+1];
+      else if (strcmp(argv[arg], "--getRV") ==0)
+	getRV = true;
+      args.push_back(argv[arg]);
+    }
+
+    arg++;
+  }
+
+  if (filenameEVENT == 0 || filenameEDP == 0) {
+    std::cerr << "ERROR - missing input args\n";
+    exit(-1);
+  }
+
+  // the worker sits next to the client
+  string workerPath("ExtractPGA");
+  string clientPath(argv[0]);
+  size_t slash = clientPath.find_last_of("/\\");
+  if (slash != string::npos)
+    workerPath = clientPath.substr(0, slash+1) + workerPath;
+
+#ifndef _WIN32
+  // the template is only written once, by ExtractPGA itself
+  string socketPath;
+  int fd = -1;
+  if (getRV == false && getWorkerSocketPath(socketName, socketPath) == 0) {
+    fd = connectWorker(socketPath.c_str());
+    if (fd < 0) {
+      startWorker(workerPath, socketName, idleTimeout);
+      for (int i=0; i<200 && fd < 0; i++) {
+	usleep(10000);
+	fd = connectWorker(socketPath.c_str());
+      }
+    }
+  }
+
+  if (fd >= 0) {
+    int result = sendWorkItem(fd, absolutePath(filenameEVENT), absolutePath(filenameEDP),
+			      filenameBIM ? absolutePath(filenameBIM) : string(),
+			      filenameResults ? absolutePath(filenameResults) : string());
+    close(fd);
+    if (result == 0)
+      return 0;
+    if (result == -1)
+      exit(-1);
+    // the worker went away mid item, fall through and do it here
+  }
+
+  if (getRV == false)
+    std::cerr << "WARNING - no ExtractPGA worker on " << socketName << ", running ExtractPGA directly\n";
+#endif
+
+  args[0] = (char *)workerPath.c_str();
+  args.push_back(NULL);
+  execvp(args[0], args.data());
+
+  std::cerr << "ERROR - could not run " << workerPath << "\n";
+  exit(-1);
+}
@@ -5,7 +5,7 @@
 #include <QVector>
 #include <timeIntegrators.h>
 
-#define PI 3.14159
+#define PI 3.14159265358979323846
 /*****
 int CalcResponseSpectrum(std::vector<double> &periods,
 			 double dampingRatio, 
@@ -126,8 +126,7 @@ int CalcResponseSpectrum(const QVector<double> &periods,
     // store results
     //
     dispResponse[count] = dispMax;
-    //dispResponse.push_back(dispMax);
-    accelResponse.push_back(dispMax * natural_freq* natural_freq / 9.81);
+    accelResponse[count] = dispMax * natural_freq* natural_freq / 9.81;
     count++;
   }
   return 0;